@@ -1,13 +1,240 @@
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+#include <stddef.h>
+
 #include "i2c.h"
 
+/* ------------------------------------------------------------
+   Coda di transazioni e stato del motore a interrupt
+------------------------------------------------------------ */
+#define I2C_QUEUE_MASK (I2C_QUEUE_SIZE - 1)
+
+// TWCR per proseguire la transazione con interrupt abilitato
+#define TWCR_NEXT ((1 << TWINT) | (1 << TWEN) | (1 << TWIE))
+
+static I2C_xfer_t * volatile i2c_queue[I2C_QUEUE_SIZE];
+static volatile uint8_t q_head = 0, q_tail = 0;
+static volatile uint8_t i2c_running = 0;
+static uint8_t xfer_idx;   // indice del byte corrente (solo ISR)
+static uint32_t i2c_hz = 0; // frequenza SCL effettiva
+
+/* ------------------------------------------------------------
+   I2C_set_speed()
+   Calcola prescaler e TWBR per la frequenza richiesta:
+   SCL = F_CPU / (16 + 2 * TWBR * 4^TWPS)
+   Arrotonda per eccesso il divisore, così la frequenza effettiva
+   non supera mai quella richiesta.
+   Ritorna 0 se valida, 1 se fuori dai limiti
+------------------------------------------------------------ */
+uint8_t I2C_set_speed(uint32_t hz) {
+    if (hz == 0 || hz > I2C_MAX_HZ) return 1;
+
+    uint32_t div = (F_CPU + hz - 1) / hz;
+    if (div < 16 + 2 * I2C_TWBR_MIN) return 1; // troppo veloce per questo F_CPU
+
+    for (uint8_t ps = 0; ps < 4; ps++) {
+        uint32_t step = 2UL << (2 * ps);       // 2 * 4^ps
+        uint32_t twbr = (div - 16 + step - 1) / step;
+        if (twbr <= 255) {
+            while (i2c_running);               // non cambia velocità a metà transazione
+            TWSR = ps;                         // TWPS1:0
+            TWBR = (uint8_t)twbr;
+            i2c_hz = F_CPU / (16 + step * twbr);
+            return 0;
+        }
+    }
+    return 1; // troppo lento per questo F_CPU
+}
+
+/* ------------------------------------------------------------
+   I2C_get_speed()
+   Ritorna la frequenza SCL effettiva in Hz
+------------------------------------------------------------ */
+uint32_t I2C_get_speed(void) {
+    return i2c_hz;
+}
+
 /* ------------------------------------------------------------
    I2C_init()
-   Inizializza l'interfaccia I2C in modalità Master.
-   Configura il prescaler e il bitrate per 100 kHz (F_CPU = 16 MHz)
+   Inizializza l'interfaccia I2C in modalità Master alla
+   frequenza richiesta (100 kHz se non valida)
+------------------------------------------------------------ */
+uint8_t I2C_init(uint32_t hz) {
+    uint8_t err = I2C_set_speed(hz);
+    if (err) I2C_set_speed(100000UL);
+    TWCR = (1 << TWEN);
+
+    sei(); // il motore a interrupt richiede interrupt globali
+    return err;
+}
+
+/* ------------------------------------------------------------
+   I2C_xfer_write_reg() / I2C_xfer_write_bulk() / I2C_xfer_read_regs()
+   Preparano un descrittore di transazione
+------------------------------------------------------------ */
+static void I2C_xfer_setup(I2C_xfer_t *x, uint8_t op, uint8_t dev, uint8_t reg,
+                           uint8_t *buf, uint8_t len) {
+    x->op     = op;
+    x->dev    = dev;
+    x->reg    = reg;
+    x->buf    = buf;
+    x->len    = len;
+    x->state  = I2C_XFER_IDLE;
+    x->status = 0;
+    x->cb     = NULL;
+    x->user   = NULL;
+}
+
+void I2C_xfer_write_reg(I2C_xfer_t *x, uint8_t dev, uint8_t reg, uint8_t val) {
+    I2C_xfer_setup(x, I2C_OP_WRITE_REG, dev, reg, &x->data, 1);
+    x->data = val;
+}
+
+void I2C_xfer_write_bulk(I2C_xfer_t *x, uint8_t dev, uint8_t reg, const uint8_t *buf, uint8_t len) {
+    I2C_xfer_setup(x, I2C_OP_WRITE_BULK, dev, reg, (uint8_t *)buf, len);
+}
+
+void I2C_xfer_read_regs(I2C_xfer_t *x, uint8_t dev, uint8_t reg, uint8_t *buf, uint8_t len) {
+    I2C_xfer_setup(x, I2C_OP_READ_REGS, dev, reg, buf, len);
+}
+
+/* ------------------------------------------------------------
+   I2C_submit()
+   Accoda una transazione e, se il bus è libero, invia START.
+   Può essere chiamata anche da una callback di completamento.
+   Ritorna 0 se accodata, 1 se la coda è piena
+------------------------------------------------------------ */
+uint8_t I2C_submit(I2C_xfer_t *x) {
+    if (x->op == I2C_OP_WRITE_REG) x->buf = &x->data;
+
+    if (x->op == I2C_OP_READ_REGS && x->len == 0) { // niente da leggere
+        x->status = 0;
+        x->state  = I2C_XFER_DONE;
+        return 0;
+    }
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        uint8_t next = (q_head + 1) & I2C_QUEUE_MASK;
+        if (next == q_tail) return 1; // coda piena
+
+        x->state  = I2C_XFER_PENDING;
+        x->status = 0;
+        i2c_queue[q_head] = x;
+        q_head = next;
+
+        if (!i2c_running) {
+            i2c_running = 1;
+            while (TWCR & (1 << TWSTO));      // attende la fine dello STOP precedente
+            TWCR = TWCR_NEXT | (1 << TWSTA);  // START
+        }
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------
+   I2C_wait()
+   Attende il completamento di una transazione accodata
+   Ritorna: 0 in caso di successo, codice TWSR altrimenti
+------------------------------------------------------------ */
+uint8_t I2C_wait(I2C_xfer_t *x) {
+    while (x->state == I2C_XFER_PENDING);
+    return x->status;
+}
+
+/* ------------------------------------------------------------
+   I2C_busy()
+   Ritorna 1 se ci sono transazioni in corso o in coda
+------------------------------------------------------------ */
+uint8_t I2C_busy(void) {
+    return i2c_running;
+}
+
+/* ------------------------------------------------------------
+   I2C_run()
+   Accoda una transazione e ne attende la fine (bloccante)
 ------------------------------------------------------------ */
-void I2C_init(void) {
-    TWSR = 0x00;                                   // Prescaler = 1
-    TWBR = ((F_CPU / 100000UL) - 16) / 2;          // Bitrate = 100 kHz
+static uint8_t I2C_run(I2C_xfer_t *x) {
+    while (I2C_submit(x)); // coda piena: attende spazio
+    return I2C_wait(x);
+}
+
+/* ------------------------------------------------------------
+   I2C_complete()
+   Chiude la transazione in testa alla coda (solo da ISR).
+   Se ci sono altre transazioni, STOP e START vengono inviati
+   insieme (TWSTO + TWSTA) senza tornare al main loop.
+------------------------------------------------------------ */
+static void I2C_complete(uint8_t status) {
+    I2C_xfer_t *x = i2c_queue[q_tail];
+    q_tail = (q_tail + 1) & I2C_QUEUE_MASK;
+
+    x->status = status;
+    x->state  = I2C_XFER_DONE;
+    if (x->cb) x->cb(x);   // può accodare nuove transazioni
+
+    if (q_tail != q_head) {
+        TWCR = TWCR_NEXT | (1 << TWSTO) | (1 << TWSTA);
+    } else {
+        TWCR = (1 << TWINT) | (1 << TWEN) | (1 << TWSTO);
+        i2c_running = 0;
+    }
+}
+
+/* ------------------------------------------------------------
+   ISR: macchina a stati TWI (TWI_vect)
+   Avanza la transazione in testa alla coda in base al codice
+   di stato in TWSR
+------------------------------------------------------------ */
+ISR(TWI_vect) {
+    I2C_xfer_t *x = i2c_queue[q_tail];
+    uint8_t st = TWSR & 0xF8;
+
+    switch (st) {
+        case 0x08: // START inviato
+            xfer_idx = 0;
+            TWDR = (x->dev << 1) | I2C_WRITE;
+            TWCR = TWCR_NEXT;
+            break;
+
+        case 0x10: // START ripetuto inviato (fase di lettura)
+            TWDR = (x->dev << 1) | I2C_READ;
+            TWCR = TWCR_NEXT;
+            break;
+
+        case 0x18: // SLA+W, ACK ricevuto: invia il registro
+            TWDR = x->reg;
+            TWCR = TWCR_NEXT;
+            break;
+
+        case 0x28: // byte inviato, ACK ricevuto
+            if (x->op == I2C_OP_READ_REGS) {
+                TWCR = TWCR_NEXT | (1 << TWSTA);   // START ripetuto
+            } else if (xfer_idx < x->len) {
+                TWDR = x->buf[xfer_idx++];
+                TWCR = TWCR_NEXT;
+            } else {
+                I2C_complete(0);
+            }
+            break;
+
+        case 0x40: // SLA+R, ACK ricevuto
+            TWCR = (x->len > 1) ? (TWCR_NEXT | (1 << TWEA)) : TWCR_NEXT;
+            break;
+
+        case 0x50: // byte ricevuto, ACK inviato
+            x->buf[xfer_idx++] = TWDR;
+            TWCR = (xfer_idx + 1 < x->len) ? (TWCR_NEXT | (1 << TWEA)) : TWCR_NEXT;
+            break;
+
+        case 0x58: // ultimo byte ricevuto, NACK inviato
+            x->buf[xfer_idx] = TWDR;
+            I2C_complete(0);
+            break;
+
+        default:   // NACK, arbitraggio perso o errore di bus
+            I2C_complete(st);
+            break;
+    }
 }
 
 /* ------------------------------------------------------------
@@ -16,8 +243,11 @@ void I2C_init(void) {
    device_addr: indirizzo a 7 bit dello slave
    mode: I2C_WRITE (0) o I2C_READ (1)
    Ritorna: codice di stato TWI (registri TWSR)
+   Attende che il motore a interrupt abbia svuotato la coda
 ------------------------------------------------------------ */
 uint8_t I2C_start(uint8_t device_addr, uint8_t mode) {
+    while (i2c_running);
+
     // Invia condizione START
     TWCR = (1 << TWSTA) | (1 << TWEN) | (1 << TWINT);
     while (!(TWCR & (1 << TWINT))); // Aspetta il completamento (TWINT settato a 1)
@@ -80,12 +310,9 @@ uint8_t I2C_read_nack(void) {
    Ritorna 0 in caso di successo, codice di errore altrimenti
 ------------------------------------------------------------ */
 uint8_t I2C_write_reg(uint8_t dev, uint8_t reg, uint8_t val) {
-    uint8_t st;
-    st = I2C_start(dev, I2C_WRITE);  if (st != 0x18) { I2C_stop(); return st; }
-    st = I2C_write(reg);             if (st != 0x28) { I2C_stop(); return st; }
-    st = I2C_write(val);             if (st != 0x28) { I2C_stop(); return st; }
-    I2C_stop();
-    return 0;
+    I2C_xfer_t x;
+    I2C_xfer_write_reg(&x, dev, reg, val);
+    return I2C_run(&x);
 }
 
 /* ------------------------------------------------------------
@@ -97,13 +324,7 @@ uint8_t I2C_write_reg(uint8_t dev, uint8_t reg, uint8_t val) {
    Ritorna 0 in caso di successo, codice di errore altrimenti
 ------------------------------------------------------------ */
 uint8_t I2C_read_reg(uint8_t dev, uint8_t reg, uint8_t *out) {
-    uint8_t st;
-    st = I2C_start(dev, I2C_WRITE);  if (st != 0x18) { I2C_stop(); return st; }
-    st = I2C_write(reg);             if (st != 0x28) { I2C_stop(); return st; }
-    st = I2C_start(dev, I2C_READ);   if (st != 0x40) { I2C_stop(); return st; }
-    *out = I2C_read_nack();
-    I2C_stop();
-    return 0;
+    return I2C_read_regs(dev, reg, out, 1);
 }
 
 /* ------------------------------------------------------------
@@ -115,18 +336,50 @@ uint8_t I2C_read_reg(uint8_t dev, uint8_t reg, uint8_t *out) {
    len: numero di byte da leggere
 ------------------------------------------------------------ */
 uint8_t I2C_read_regs(uint8_t dev, uint8_t start_reg, uint8_t *buf, uint8_t len) {
-    uint8_t st;
-    st = I2C_start(dev, I2C_WRITE);  if (st != 0x18) { I2C_stop(); return st; }
-    st = I2C_write(start_reg);       if (st != 0x28) { I2C_stop(); return st; }
-    st = I2C_start(dev, I2C_READ);   if (st != 0x40) { I2C_stop(); return st; }
+    I2C_xfer_t x;
+    I2C_xfer_read_regs(&x, dev, start_reg, buf, len);
+    return I2C_run(&x);
+}
 
-    for (uint8_t i = 0; i < len - 1; ++i)
-        buf[i] = I2C_read_ack();
+/* ------------------------------------------------------------
+   I2C_write_bulk()
+   Scrive più byte consecutivi a partire da un registro
+   (o dopo un byte di controllo) in un'unica transazione
+   Ritorna 0 in caso di successo, codice di errore altrimenti
+------------------------------------------------------------ */
+uint8_t I2C_write_bulk(uint8_t dev, uint8_t reg, const uint8_t *buf, uint8_t len) {
+    I2C_xfer_t x;
+    I2C_xfer_write_bulk(&x, dev, reg, buf, len);
+    return I2C_run(&x);
+}
 
-    buf[len - 1] = I2C_read_nack();
-    I2C_stop();
+/* ------------------------------------------------------------
+   I2C_stream_begin()
+   Apre una transazione di scrittura e invia il byte di controllo
+   Ritorna 0 in caso di successo, codice di errore altrimenti
+   (in caso di errore il bus è già stato rilasciato)
+------------------------------------------------------------ */
+uint8_t I2C_stream_begin(uint8_t dev, uint8_t ctrl) {
+    uint8_t st;
+    st = I2C_start(dev, I2C_WRITE);  if (st != 0x18) { I2C_stop(); return st; }
+    st = I2C_write(ctrl);            if (st != 0x28) { I2C_stop(); return st; }
     return 0;
 }
 
+/* ------------------------------------------------------------
+   I2C_stream_write()
+   Invia un byte di dati nella transazione aperta
+   Ritorna 0 in caso di successo, codice TWSR altrimenti
+------------------------------------------------------------ */
+uint8_t I2C_stream_write(uint8_t data) {
+    uint8_t st = I2C_write(data);
+    return (st == 0x28) ? 0 : st;
+}
 
-
+/* ------------------------------------------------------------
+   I2C_stream_end()
+   Chiude la transazione con STOP
+------------------------------------------------------------ */
+void I2C_stream_end(void) {
+    I2C_stop();
+}
@@ -10,10 +10,86 @@
 #define I2C_WRITE  0
 #define I2C_READ   1
 
+/* ------------------------------------------------------------
+   Motore TWI a interrupt con coda di transazioni
+   I descrittori sono allocati dal chiamante e devono restare
+   validi finché state != I2C_XFER_PENDING.
+------------------------------------------------------------ */
+#define I2C_QUEUE_SIZE 8   // potenza di 2
+
+typedef enum {
+    I2C_OP_WRITE_REG  = 0,  // START, SLA+W, reg, data, STOP
+    I2C_OP_WRITE_BULK = 1,  // START, SLA+W, reg, buf[0..len-1], STOP
+    I2C_OP_READ_REGS  = 2   // START, SLA+W, reg, RSTART, SLA+R, buf[0..len-1], STOP
+} I2C_op_t;
+
+typedef enum {
+    I2C_XFER_IDLE    = 0,
+    I2C_XFER_PENDING = 1,
+    I2C_XFER_DONE    = 2
+} I2C_xfer_state_t;
+
+typedef struct I2C_xfer I2C_xfer_t;
+
+// Callback di completamento: eseguita nel contesto della ISR TWI
+typedef void (*I2C_callback_t)(I2C_xfer_t *x);
+
+struct I2C_xfer {
+    uint8_t          op;      // I2C_op_t
+    uint8_t          dev;     // indirizzo a 7 bit dello slave
+    uint8_t          reg;     // registro (o byte di controllo) iniziale
+    uint8_t          data;    // dato per I2C_OP_WRITE_REG
+    uint8_t         *buf;     // buffer dati (bulk-write / read-regs)
+    uint8_t          len;     // numero di byte in buf
+    volatile uint8_t state;   // I2C_xfer_state_t
+    volatile uint8_t status;  // 0 = successo, altrimenti codice TWSR
+    I2C_callback_t   cb;      // opzionale (NULL)
+    void            *user;    // contesto libero per la callback
+};
+
+/* ------------------------------------------------------------
+   Velocità del bus
+   I2C_BUS_HZ può essere ridefinito in compilazione
+   (es. -DI2C_BUS_HZ=100000UL)
+------------------------------------------------------------ */
+#ifndef I2C_BUS_HZ
+#define I2C_BUS_HZ  400000UL   // Fast-mode (BME280 e SH1106 lo supportano)
+#endif
+
+#define I2C_MAX_HZ  400000UL   // limite Fast-mode
+#define I2C_TWBR_MIN 10        // valore minimo consigliato in modalità master
+
 /* ------------------------------------------------------------
    Inizializzazione
+   Ritorna 0 se la velocità richiesta è valida, 1 altrimenti
+   (in tal caso il bus viene configurato a 100 kHz)
 ------------------------------------------------------------ */
-void I2C_init(void);
+uint8_t I2C_init(uint32_t hz);
+
+// Cambia la velocità a runtime (attende la fine delle transazioni)
+// Ritorna 0 se valida, 1 se non raggiungibile con F_CPU
+uint8_t I2C_set_speed(uint32_t hz);
+
+// Velocità effettiva impostata (Hz)
+uint32_t I2C_get_speed(void);
+
+/* ------------------------------------------------------------
+   API asincrona
+------------------------------------------------------------ */
+// Preparano un descrittore (cb e user azzerati)
+void I2C_xfer_write_reg(I2C_xfer_t *x, uint8_t dev, uint8_t reg, uint8_t val);
+void I2C_xfer_write_bulk(I2C_xfer_t *x, uint8_t dev, uint8_t reg, const uint8_t *buf, uint8_t len);
+void I2C_xfer_read_regs(I2C_xfer_t *x, uint8_t dev, uint8_t reg, uint8_t *buf, uint8_t len);
+
+// Accoda una transazione: 0 se accodata, 1 se la coda è piena
+uint8_t I2C_submit(I2C_xfer_t *x);
+
+// Attende il completamento di una transazione e ne ritorna lo stato
+// (richiede interrupt abilitati, non usare da ISR)
+uint8_t I2C_wait(I2C_xfer_t *x);
+
+// 1 se il motore sta eseguendo transazioni
+uint8_t I2C_busy(void);
 
 /* ------------------------------------------------------------
    Primitive di basso livello (START, STOP, read/write singolo byte)
@@ -26,6 +102,7 @@ uint8_t I2C_read_nack(void);
 
 /* ------------------------------------------------------------
    Funzioni di alto livello (accesso a registri)
+   Bloccanti: accodano una transazione e ne attendono la fine
 ------------------------------------------------------------ */
 // Scrive un byte in un registro di uno slave
 uint8_t I2C_write_reg(uint8_t dev, uint8_t reg, uint8_t val);
@@ -36,5 +113,18 @@ uint8_t I2C_read_reg(uint8_t dev, uint8_t reg, uint8_t *out);
 // Legge più byte consecutivi (es. per sensori tipo BME280)
 uint8_t I2C_read_regs(uint8_t dev, uint8_t start_reg, uint8_t *buf, uint8_t len);
 
+// Scrive len byte dopo il registro/byte di controllo in un'unica transazione
+uint8_t I2C_write_bulk(uint8_t dev, uint8_t reg, const uint8_t *buf, uint8_t len);
+
+/* ------------------------------------------------------------
+   Scrittura in streaming (bloccante)
+   Una sola transazione: START, SLA+W, byte di controllo,
+   N byte di dati inviati uno alla volta, STOP.
+   Utile quando i dati sono generati al volo (es. glifi OLED).
+------------------------------------------------------------ */
+uint8_t I2C_stream_begin(uint8_t dev, uint8_t ctrl);
+uint8_t I2C_stream_write(uint8_t data);
+void    I2C_stream_end(void);
+
 
 
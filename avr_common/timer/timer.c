@@ -0,0 +1,58 @@
+#include <util/atomic.h>
+
+#include "timer.h"
+
+/* ------------------------------------------------------------
+   Contatore dei millisecondi (aggiornato dalla ISR)
+------------------------------------------------------------ */
+static volatile uint32_t timer_ms = 0;
+
+/* ------------------------------------------------------------
+   TIMER_init()
+   Configura Timer2 in CTC con interrupt ogni millisecondo
+------------------------------------------------------------ */
+void TIMER_init(void) {
+    TCCR2A = (1 << WGM21);                // CTC, TOP = OCR2A
+    TCCR2B = (1 << CS22);                 // prescaler 64
+    OCR2A  = TIMER_TOP;
+    TCNT2  = 0;
+    TIMSK2 = (1 << OCIE2A);               // interrupt su compare match A
+
+    sei();
+}
+
+/* ------------------------------------------------------------
+   TIMER_millis()
+   Ritorna i millisecondi trascorsi dall'avvio
+------------------------------------------------------------ */
+uint32_t TIMER_millis(void) {
+    uint32_t ms;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        ms = timer_ms;
+    }
+    return ms;
+}
+
+/* ------------------------------------------------------------
+   TIMER_micros()
+   Ritorna i microsecondi trascorsi dall'avvio
+   Combina il contatore dei ms con TCNT2 (1 tick = 4 us);
+   se il compare match è pendente il ms non è ancora contato
+------------------------------------------------------------ */
+uint32_t TIMER_micros(void) {
+    uint32_t ms;
+    uint8_t  cnt;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        ms  = timer_ms;
+        cnt = TCNT2;
+        if ((TIFR2 & (1 << OCF2A)) && cnt < TIMER_TOP) ms++;
+    }
+    return ms * 1000UL + (uint32_t)cnt * (1000000UL / (F_CPU / TIMER_PRESCALER));
+}
+
+/* ------------------------------------------------------------
+   ISR: Compare match Timer2 (TIMER2_COMPA_vect)
+------------------------------------------------------------ */
+ISR(TIMER2_COMPA_vect) {
+    timer_ms++;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stdint.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+/* ------------------------------------------------------------
+   Base dei tempi di sistema
+   Timer2 in modalità CTC: F_CPU / 64 / 250 = 1 kHz (1 tick = 1 ms)
+------------------------------------------------------------ */
+#define TIMER_PRESCALER 64
+#define TIMER_TOP       ((F_CPU / TIMER_PRESCALER / 1000UL) - 1)
+
+/* ------------------------------------------------------------
+   API Timer
+------------------------------------------------------------ */
+void     TIMER_init(void);
+uint32_t TIMER_millis(void);   // ms dall'avvio
+uint32_t TIMER_micros(void);   // us dall'avvio (risoluzione 4 us)
@@ -1,7 +1,12 @@
+#include <string.h>
+#include <util/atomic.h>
+
 #include "uart.h"
 
 /* ------------------------------------------------------------
    Buffer circolari 
+   head è scritto solo dal produttore, tail solo dal consumatore:
+   uno slot resta sempre libero per distinguere pieno da vuoto
 ------------------------------------------------------------ */
 static volatile uint8_t rx_buf[UART_RX_BUF_SIZE]; // buffer di ricezione
 static volatile uint8_t rx_head = 0, rx_tail = 0;
@@ -9,35 +14,167 @@ static volatile uint8_t rx_head = 0, rx_tail = 0;
 static volatile uint8_t tx_buf[UART_TX_BUF_SIZE]; // buffer di trasmissione 
 static volatile uint8_t tx_head = 0, tx_tail = 0;
 
+static volatile UART_stats_t stats;
+
+static uint32_t uart_baud = 0;   // velocità effettiva
+static uint8_t  tx_used = 0;     // almeno un byte trasmesso (TXC0 significativo)
+
 /* ------------------------------------------------------------
-   UART_init()
-   Configura la UART: 19200 baud, 8N1
+   Riga in costruzione per UART_poll_line()
+------------------------------------------------------------ */
+static char    line_buf[UART_LINE_MAX];
+static uint8_t line_len = 0;
+static uint8_t line_overflow = 0;   // caratteri scartati nella riga corrente
+
+/* ------------------------------------------------------------
+   UART_flush()
+   Attende che buffer TX e registro a scorrimento siano vuoti
+   (TXC0 viene azzerato dalla ISR a ogni byte scritto in UDR0)
+------------------------------------------------------------ */
+void UART_flush(void) {
+    while (UCSR0B & (1 << UDRIE0));          // la ISR svuota il buffer
+    if (tx_used) while (!(UCSR0A & (1 << TXC0)));
+}
+
+/* ------------------------------------------------------------
+   UART_divisor()
+   Baud = F_CPU / (8 * (UBRR + 1)) con U2X0 attivo; il divisore
+   è arrotondato al valore più vicino.
+   Ritorna UBRR + 1, oppure 0 se la velocità è fuori dai limiti
+   o troppo imprecisa
+------------------------------------------------------------ */
+static uint16_t UART_divisor(uint32_t baud) {
+    if (baud == 0 || baud > UART_MAX_BAUD) return 0;
+
+    uint32_t div = (F_CPU / 8 + baud / 2) / baud;
+    if (div < 1 || div > 4096) return 0;
+
+    uint32_t actual = F_CPU / 8 / div;
+    uint32_t diff = (actual > baud) ? actual - baud : baud - actual;
+    if (diff * 1000 / baud > UART_MAX_ERR_PERMILLE) return 0;
+    return (uint16_t)div;
+}
+
+/* ------------------------------------------------------------
+   UART_baud_valid()
+   Ritorna 0 se la velocità è realizzabile, 1 altrimenti
 ------------------------------------------------------------ */
-void UART_init(uint16_t ubrr) {
+uint8_t UART_baud_valid(uint32_t baud) {
+    return UART_divisor(baud) ? 0 : 1;
+}
+
+/* ------------------------------------------------------------
+   UART_set_baud()
+   Ritorna 0 se valida, 1 se non realizzabile (nulla cambia)
+------------------------------------------------------------ */
+uint8_t UART_set_baud(uint32_t baud) {
+    uint16_t div = UART_divisor(baud);
+    if (!div) return 1;
+
+    UART_flush();   // non cambia velocità a metà di un byte
+    uint16_t ubrr = div - 1;
     UBRR0H = (uint8_t)(ubrr >> 8);
     UBRR0L = (uint8_t)ubrr;
+    UCSR0A = (UCSR0A & ~(1 << TXC0)) | (1 << U2X0);   // scrivere 1 in TXC0 lo azzererebbe
+    uart_baud = F_CPU / 8 / div;
+    return 0;
+}
+
+/* ------------------------------------------------------------
+   UART_get_baud()
+------------------------------------------------------------ */
+uint32_t UART_get_baud(void) {
+    return uart_baud;
+}
+
+/* ------------------------------------------------------------
+   UART_init()
+   Configura la UART: 8N1 alla velocità richiesta
+   (UART_BAUD se non valida)
+------------------------------------------------------------ */
+uint8_t UART_init(uint32_t baud) {
+    uint8_t err = UART_set_baud(baud);
+    if (err) UART_set_baud(UART_BAUD);
 
     UCSR0C = (1 << UCSZ01) | (1 << UCSZ00); // 8 bit, no parity, 1 stop
     UCSR0B = (1 << RXEN0) | (1 << TXEN0) |  // abilita RX e TX
              (1 << RXCIE0);                 // abilita interrupt RX
 
     sei(); // abilita interrupt globali
+    return err;
 }
 
 /* ------------------------------------------------------------
    UART_putChar()
    Inserisce un carattere nel buffer TX e abilita interrupt TX
 ------------------------------------------------------------ */
+static inline void stat_inc(volatile uint16_t *c) {
+    if (*c != 0xFFFF) (*c)++;
+}
+
 void UART_putChar(char data) {
-    uint8_t next = (tx_head + 1) % UART_TX_BUF_SIZE;
-    while (next == tx_tail); // il buffer è pieno, attende spazio libero
+    uint8_t next = (tx_head + 1) & UART_TX_MASK;
+    if (next == tx_tail) {
+        stat_inc(&stats.tx_stalls);
+        while (next == tx_tail); // il buffer è pieno, attende spazio libero
+    }
 
     tx_buf[tx_head] = data;
     tx_head = next;
+    tx_used = 1;
 
     UCSR0B |= (1 << UDRIE0); // abilita interrupt "data register empty" (UDR0 vuoto)
 }
 
+/* ------------------------------------------------------------
+   UART_tx_free()
+   Numero di byte che UART_write() accetterebbe ora
+------------------------------------------------------------ */
+uint8_t UART_tx_free(void) {
+    return (uint8_t)((tx_tail - tx_head - 1) & UART_TX_MASK);
+}
+
+/* ------------------------------------------------------------
+   UART_write()
+   Copia nel buffer TX quanti più byte possibile senza attendere
+   e ritorna quanti ne ha accettati; il chiamante decide se
+   riprovare, ridurre o scartare il resto
+------------------------------------------------------------ */
+uint8_t UART_write(const void *buf, uint8_t len) {
+    const uint8_t *p = (const uint8_t *)buf;
+    uint8_t room = UART_tx_free();
+    uint8_t n = (len < room) ? len : room;
+    uint8_t head = tx_head;
+
+    for (uint8_t i = 0; i < n; i++) {
+        tx_buf[head] = p[i];
+        head = (head + 1) & UART_TX_MASK;
+    }
+    tx_head = head;   // pubblica tutti i byte in una volta
+
+    if (n) {
+        tx_used = 1;
+        UCSR0B |= (1 << UDRIE0);
+    }
+    if (n < len) stat_inc(&stats.tx_short);
+    return n;
+}
+
+/* ------------------------------------------------------------
+   UART_get_stats() / UART_reset_stats()
+------------------------------------------------------------ */
+void UART_get_stats(UART_stats_t *st) {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        *st = *(UART_stats_t *)&stats;
+    }
+}
+
+void UART_reset_stats(void) {
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        memset((void *)&stats, 0, sizeof(stats));
+    }
+}
+
 /* ------------------------------------------------------------
    UART_getChar()
    Ritorna il primo carattere nel buffer RX (bloccante)
@@ -45,7 +182,7 @@ void UART_putChar(char data) {
 char UART_getChar(void) {
     while (rx_head == rx_tail); // attende dati disponibili
     char c = rx_buf[rx_tail];
-    rx_tail = (rx_tail + 1) % UART_RX_BUF_SIZE;
+    rx_tail = (rx_tail + 1) & UART_RX_MASK;
     return c;
 }
 
@@ -57,6 +194,15 @@ void UART_putString(const char *s) {
     while (*s) UART_putChar(*s++);
 }
 
+/* ------------------------------------------------------------
+   UART_putString_P()
+   Invia una stringa memorizzata in flash (PSTR)
+------------------------------------------------------------ */
+void UART_putString_P(const char *s) {
+    char c;
+    while ((c = (char)pgm_read_byte(s++))) UART_putChar(c);
+}
+
 /* ------------------------------------------------------------
    UART_getString()
    Legge una riga con terminatore '\r' o '\n'
@@ -75,17 +221,52 @@ int UART_getString(char *buf, int maxlen) {
     return i;
 }
 
+/* ------------------------------------------------------------
+   UART_poll_line()
+   Consuma i byte già presenti nel buffer RX (riempito dalla ISR)
+   e ritorna una riga solo quando è terminata da '\r' o '\n'.
+   Una riga più lunga di UART_LINE_MAX - 1 (o di maxlen - 1)
+   viene scartata per intero: ritorna UART_LINE_OVERFLOW, così
+   un argomento troncato non diventa un comando valido.
+------------------------------------------------------------ */
+int UART_poll_line(char *buf, int maxlen) {
+    while (rx_head != rx_tail) {
+        char c = rx_buf[rx_tail];
+        rx_tail = (rx_tail + 1) & UART_RX_MASK;
+
+        if (c == '\r' || c == '\n') {
+            if (line_overflow || line_len > maxlen - 1) {
+                line_overflow = 0;
+                line_len = 0;
+                return UART_LINE_OVERFLOW;
+            }
+            if (line_len == 0) continue;   // es. '\n' dopo '\r'
+            int n = line_len;
+            memcpy(buf, line_buf, n);
+            buf[n] = '\0';
+            line_len = 0;
+            return n;
+        }
+        if (line_len < UART_LINE_MAX - 1) line_buf[line_len++] = c;
+        else line_overflow = 1;
+    }
+    return -1;
+}
+
 /* ------------------------------------------------------------
    ISR: Ricezione (USART0_RX_vect)
    Viene chiamata automaticamente quando arriva un byte
 ------------------------------------------------------------ */
 ISR(USART0_RX_vect) {
+    if (UCSR0A & (1 << DOR0)) stat_inc(&stats.rx_overrun);  // da leggere prima di UDR0
     uint8_t data = UDR0;
-    uint8_t next = (rx_head + 1) % UART_RX_BUF_SIZE;
+    uint8_t next = (rx_head + 1) & UART_RX_MASK;
 
     if (next != rx_tail) { // Controlla se il buffer non è pieno
         rx_buf[rx_head] = data;
         rx_head = next;
+    } else {
+        stat_inc(&stats.rx_dropped);
     }
 }
 
@@ -97,8 +278,9 @@ ISR(USART0_UDRE_vect) {
     if (tx_head == tx_tail) {
         UCSR0B &= ~(1 << UDRIE0); // disabilita interrupt se buffer vuoto
     } else {
+        UCSR0A |= (1 << TXC0);    // azzera TXC0: si riattiva a fine trasmissione
         UDR0 = tx_buf[tx_tail];
-        tx_tail = (tx_tail + 1) % UART_TX_BUF_SIZE;
+        tx_tail = (tx_tail + 1) & UART_TX_MASK;
     }
 }
 
@@ -3,24 +3,82 @@
 #include <stdint.h>
 #include <avr/io.h>
 #include <avr/interrupt.h>
+#include <avr/pgmspace.h>
 
 /* ------------------------------------------------------------
    Configurazione UART
 ------------------------------------------------------------ */
-#define UART_BAUD        19200
+#define UART_BAUD        19200UL   // velocità sicura all'avvio
+#define UART_LINE_MAX    48   // lunghezza massima di una riga di comando
+
+/* ------------------------------------------------------------
+   Dimensione dei buffer circolari: potenze di 2 fino a 256,
+   indicizzate con maschera. Ridefinibili in compilazione
+   (es. -DUART_TX_BUF_SIZE=256)
+------------------------------------------------------------ */
+#ifndef UART_RX_BUF_SIZE
 #define UART_RX_BUF_SIZE 64
-#define UART_TX_BUF_SIZE 64
-#define UART_MYUBRR (F_CPU / 16 / UART_BAUD - 1)
+#endif
+#ifndef UART_TX_BUF_SIZE
+#define UART_TX_BUF_SIZE 128
+#endif
+
+#if (UART_RX_BUF_SIZE & (UART_RX_BUF_SIZE - 1)) || UART_RX_BUF_SIZE > 256
+#error "UART_RX_BUF_SIZE deve essere una potenza di 2 non superiore a 256"
+#endif
+#if (UART_TX_BUF_SIZE & (UART_TX_BUF_SIZE - 1)) || UART_TX_BUF_SIZE > 256
+#error "UART_TX_BUF_SIZE deve essere una potenza di 2 non superiore a 256"
+#endif
+
+#define UART_RX_MASK (UART_RX_BUF_SIZE - 1)
+#define UART_TX_MASK (UART_TX_BUF_SIZE - 1)
+
+/* ------------------------------------------------------------
+   Contatori di errore/saturazione (saturano a 0xFFFF)
+------------------------------------------------------------ */
+typedef struct {
+    uint16_t rx_overrun;   // byte persi in hardware (DOR0: ISR in ritardo)
+    uint16_t rx_dropped;   // byte ricevuti con buffer RX pieno
+    uint16_t tx_stalls;    // attese in UART_putChar() con buffer TX pieno
+    uint16_t tx_short;     // UART_write() che non ha accettato tutti i byte
+} UART_stats_t;
+
+/* ------------------------------------------------------------
+   Velocità
+   Sempre in modalità U2X (divisore F_CPU / 8): a 16 MHz
+   250k, 500k e 1M sono esatte, 115200 ha errore del 2.1%
+   (come il bridge USB delle schede Arduino, che usa lo stesso
+   divisore). Sono rifiutate le velocità con errore maggiore
+   di UART_MAX_ERR_PERMILLE.
+------------------------------------------------------------ */
+#define UART_MAX_BAUD         1000000UL
+#define UART_MAX_ERR_PERMILLE 25
 
 /* ------------------------------------------------------------
    API UART 
 ------------------------------------------------------------ */
-void UART_init(uint16_t ubrr);
-void UART_putChar(char data);
+uint8_t  UART_init(uint32_t baud);       // 0 = OK, 1 = velocità non valida (usa UART_BAUD)
+uint8_t  UART_baud_valid(uint32_t baud); // 0 se realizzabile
+uint8_t  UART_set_baud(uint32_t baud);   // attende la fine della trasmissione in corso
+uint32_t UART_get_baud(void);            // velocità effettiva
+void     UART_flush(void);               // attende l'invio di tutti i byte accodati
+void UART_putChar(char data);                   // bloccante se il buffer è pieno
+uint8_t UART_write(const void *buf, uint8_t len);  // non bloccante: ritorna i byte accettati
+uint8_t UART_tx_free(void);                     // byte accodabili senza attesa
+void UART_get_stats(UART_stats_t *st);
+void UART_reset_stats(void);
 char UART_getChar(void);
 void UART_putString(const char *s);
+void UART_putString_P(const char *s);   // stringa in flash (PSTR)
 int  UART_getString(char *buf, int maxlen);
 
+// Assembla una riga dai byte ricevuti (non bloccante).
+// Ritorna la lunghezza della riga completa copiata in buf,
+// -1 se la riga non è ancora terminata, UART_LINE_OVERFLOW se era
+// troppo lunga (scartata). Le righe vuote sono ignorate.
+#define UART_LINE_OVERFLOW (-2)
+int  UART_poll_line(char *buf, int maxlen);
+
 
 
 
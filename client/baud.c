@@ -0,0 +1,33 @@
+/* ------------------------------------------------------------
+   Velocità arbitrarie con termios2 / BOTHER (Linux)
+   In un file separato: <asm/termbits.h> non può essere incluso
+   insieme a <termios.h> della libc
+------------------------------------------------------------ */
+#include <asm/termbits.h>
+#include <sys/ioctl.h>
+#include <stdio.h>
+
+/* ------------------------------------------------------------
+   serial_set_baud()
+   Imposta la stessa velocità in ingresso e in uscita, anche se
+   non è una delle costanti Bxxxx. Ritorna 0 o -1 in caso di errore
+------------------------------------------------------------ */
+int serial_set_baud(int fd, int speed) {
+    struct termios2 tio;
+
+    if (ioctl(fd, TCGETS2, &tio) != 0) {
+        perror("TCGETS2");
+        return -1;
+    }
+
+    tio.c_cflag &= ~(CBAUD | (CBAUD << IBSHIFT));
+    tio.c_cflag |= BOTHER | (BOTHER << IBSHIFT);
+    tio.c_ispeed = speed;
+    tio.c_ospeed = speed;
+
+    if (ioctl(fd, TCSETS2, &tio) != 0) {
+        perror("TCSETS2");
+        return -1;
+    }
+    return 0;
+}
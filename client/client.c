@@ -5,7 +5,7 @@
 /* ------------------------------------------------------------
    serial_set_interface_attribs()
    Configura i parametri della porta seriale.
-   - Imposta baudrate (9600, 19200, 57600, 115200)
+   - Imposta baudrate (costanti standard, altrimenti termios2)
    - Modalità raw (nessuna interpretazione dei byte)
    - 8 bit, nessuna parità, 1 stop bit
 ------------------------------------------------------------ */
@@ -19,14 +19,19 @@ int serial_set_interface_attribs(int fd, int speed) {
     }
 
     speed_t baud;
+    int custom = 0;
     switch (speed) {
         case 9600:   baud = B9600; break;
         case 19200:  baud = B19200; break;
         case 57600:  baud = B57600; break;
         case 115200: baud = B115200; break;
         default:
-            fprintf(stderr, "Unsupported baudrate %d\n", speed);
-            return -1;
+            if (speed <= 0) {
+                fprintf(stderr, "Unsupported baudrate %d\n", speed);
+                return -1;
+            }
+            baud = B38400;   // segnaposto, sostituito da serial_set_baud()
+            custom = 1;
     }
 
     // Imposta velocità di trasmissione e ricezione
@@ -51,6 +56,7 @@ int serial_set_interface_attribs(int fd, int speed) {
         return -1;
     }
 
+    if (custom) return serial_set_baud(fd, speed);
     return 0;
 }
 
@@ -71,25 +77,280 @@ int serial_open(const char* device) {
     return fd;
 }
 
+/* ------------------------------------------------------------
+   Velocità provate da serial_negotiate(), dalla più alta.
+   Sono quelle esatte (o quasi) per il firmware a 16 MHz in U2X
+------------------------------------------------------------ */
+static const int serial_rates[] = { 1000000, 500000, 250000, 115200, 57600 };
+
+/* ------------------------------------------------------------
+   serial_wait_reply()
+   Legge dalla seriale finché compare token o scade il timeout;
+   il resto dei dati ricevuti nel frattempo viene scartato.
+   Ritorna 1 se trovato, 0 altrimenti
+------------------------------------------------------------ */
+static int serial_wait_reply(int fd, const char *token, int timeout_ms) {
+    char acc[512];
+    size_t len = 0;
+    struct pollfd pfd = { .fd = fd, .events = POLLIN };
+
+    while (poll(&pfd, 1, timeout_ms) > 0) {
+        if (len > sizeof(acc) / 2) {   // conserva solo la coda
+            memmove(acc, acc + len - 64, 64);
+            len = 64;
+        }
+        int n = read(fd, acc + len, sizeof(acc) - 1 - len);
+        if (n <= 0) continue;
+        len += n;
+        acc[len] = '\0';
+        for (size_t i = 0; i < len; i++)   // i byte 0x00 della telemetria troncherebbero strstr
+            if (!acc[i]) acc[i] = '\n';
+        if (strstr(acc, token)) return 1;
+    }
+    return 0;
+}
+
+static int serial_send(int fd, const char *s) {
+    size_t len = strlen(s);
+    if (write(fd, s, len) != (ssize_t)len) return -1;
+    tcdrain(fd);
+    return 0;
+}
+
+/* ------------------------------------------------------------
+   serial_negotiate()
+------------------------------------------------------------ */
+int serial_negotiate(int fd) {
+    char cmd[32], reply[32];
+
+    for (size_t i = 0; i < sizeof(serial_rates) / sizeof(serial_rates[0]); i++) {
+        int rate = serial_rates[i];
+
+        snprintf(cmd, sizeof(cmd), "\rbaud %d\r", rate);
+        snprintf(reply, sizeof(reply), "BAUD %d OK", rate);
+        if (serial_send(fd, cmd) || !serial_wait_reply(fd, reply, 500)) continue;
+
+        usleep(5000);   // il firmware cambia velocità dopo aver inviato la risposta
+        if (serial_set_interface_attribs(fd, rate) == 0) {
+            usleep(20000);
+            tcflush(fd, TCIFLUSH);
+            if (!serial_send(fd, "\rping\r") && serial_wait_reply(fd, "pong", 300))
+                return rate;
+        }
+
+        // Nessuna conferma: il firmware torna alla velocità base
+        fprintf(stderr, "%d baud not working, falling back\n", rate);
+        serial_set_interface_attribs(fd, SERIAL_BASE_BAUD);
+        usleep(SERIAL_REVERT_MS * 1000);
+        tcflush(fd, TCIFLUSH);
+    }
+    return SERIAL_BASE_BAUD;
+}
+
+/* ------------------------------------------------------------
+   cobs_decode()
+   Ogni blocco inizia con la distanza dal prossimo zero
+------------------------------------------------------------ */
+int cobs_decode(const unsigned char *in, size_t len, unsigned char *out) {
+    size_t i = 0, o = 0;
+    while (i < len) {
+        unsigned char code = in[i++];
+        if (code == 0 || i + code - 1 > len) return -1;
+        for (unsigned char k = 1; k < code; k++) out[o++] = in[i++];
+        if (code < 0xFF && i < len) out[o++] = 0;
+    }
+    return (int)o;
+}
+
+/* ------------------------------------------------------------
+   crc16_ccitt()
+   Equivalente C di _crc_ccitt_update() (polinomio 0x8408)
+------------------------------------------------------------ */
+unsigned short crc16_ccitt(const unsigned char *data, size_t len) {
+    unsigned short crc = 0xFFFF;
+    for (size_t i = 0; i < len; i++) {
+        unsigned char d = data[i] ^ (crc & 0xFF);
+        d ^= d << 4;
+        crc = ((unsigned short)d << 8 | (crc >> 8)) ^ (unsigned char)(d >> 4) ^ ((unsigned short)d << 3);
+    }
+    return crc;
+}
+
+static unsigned get16(const unsigned char *p) { return p[0] | (unsigned)p[1] << 8; }
+static unsigned long get32(const unsigned char *p) { return get16(p) | (unsigned long)get16(p + 2) << 16; }
+
+/* ------------------------------------------------------------
+   telem_bucket()
+   Stampa un intervallo dello storico (comando "dump ... bin")
+------------------------------------------------------------ */
+static void telem_bucket(const unsigned char *pkt) {
+    static const char *tiers[] = { "raw", "1m", "15m" };
+    unsigned tier = pkt[1];
+    int t[3];
+    unsigned p[3], h[3];
+
+    for (int i = 0; i < 3; i++) {
+        t[i] = (short)get16(pkt + 8 + 2 * i);
+        p[i] = get16(pkt + 14 + 2 * i);
+        h[i] = get16(pkt + 20 + 2 * i);
+    }
+
+    printf("[%s] %8lu s  n=%-4u T: %.2f/%.2f/%.2f C  P: %.1f/%.1f/%.1f hPa  H: %.2f/%.2f/%.2f %%\n",
+           tier < 3 ? tiers[tier] : "?", get32(pkt + 2), get16(pkt + 6),
+           t[0] / 100.0, t[1] / 100.0, t[2] / 100.0,
+           p[0] / 10.0, p[1] / 10.0, p[2] / 10.0,
+           h[0] / 100.0, h[1] / 100.0, h[2] / 100.0);
+    fflush(stdout);
+}
+
+/* ------------------------------------------------------------
+   telem_event()
+   Stampa un cambio di stato di una soglia
+------------------------------------------------------------ */
+static void telem_event(const unsigned char *pkt) {
+    static const char *channels[] = { "Temperature", "Pressure", "Humidity" };
+    static const char *units[] = { "C", "hPa", "%" };
+    static const char *states[] = { "cleared", "LOW", "HIGH" };
+    unsigned ch = pkt[1], st = pkt[2];
+    long v = (int)get32(pkt + 7);   // int32 con segno
+
+    printf("[ALARM] %10lu ms  %s %s: %s%ld.%02ld %s\n",
+           get32(pkt + 3), ch < 3 ? channels[ch] : "?", st < 3 ? states[st] : "?",
+           v < 0 ? "-" : "", labs(v) / 100, labs(v) % 100, ch < 3 ? units[ch] : "");
+    fflush(stdout);
+}
+
+/* ------------------------------------------------------------
+   telem_frame()
+   Verifica e stampa un pacchetto completo
+------------------------------------------------------------ */
+static void telem_frame(telem_decoder_t *d) {
+    unsigned char pkt[TELEM_BUF_SIZE];
+    int n = cobs_decode(d->buf, d->len, pkt);
+
+    // Lunghezza attesa dal tipo; 0 (mai uguale a n) se sconosciuto
+    int expected = (n <= 0) ? 0 :
+                   (pkt[0] == TELEM_TYPE_SAMPLE || pkt[0] == TELEM_TYPE_RAW) ? TELEM_SAMPLE_LEN :
+                   (pkt[0] == TELEM_TYPE_BUCKET) ? TELEM_BUCKET_LEN :
+                   (pkt[0] == TELEM_TYPE_EVENT)  ? TELEM_EVENT_LEN : 0;
+    if (n <= 0 || n != expected || crc16_ccitt(pkt, n - 2) != get16(pkt + n - 2)) {
+        d->bad++;
+        fprintf(stderr, "[telemetry] bad frame (%lu so far)\n", d->bad);
+        return;
+    }
+
+    if (pkt[0] == TELEM_TYPE_BUCKET) {
+        telem_bucket(pkt);
+        return;
+    }
+    if (pkt[0] == TELEM_TYPE_EVENT) {
+        telem_event(pkt);
+        return;
+    }
+
+    unsigned seq = get16(pkt + 1);
+    unsigned long ms = get32(pkt + 3);
+    int temp = (short)get16(pkt + 7);          // centesimi di °C
+    unsigned long press = get32(pkt + 9);      // Pa
+    unsigned hum = get16(pkt + 13);            // centesimi di %RH
+
+    // I campioni dello storico ("dump raw bin") non contano
+    // per le perdite; un salto all'indietro è un riavvio
+    int history = (pkt[0] == TELEM_TYPE_RAW);
+    if (!history) {
+        unsigned gap = (seq - d->last_seq - 1) & 0xFFFF;
+        if (d->have_seq && gap < 0x8000) d->lost += gap;
+        d->have_seq = 1;
+        d->last_seq = seq;
+    }
+
+    printf("%s#%-5u %10lu ms  T: %s%d.%02d C  P: %lu.%02lu hPa  H: %u.%02u %%",
+           history ? "[raw] " : "", seq, ms, (temp < 0 ? "-" : ""), abs(temp) / 100, abs(temp) % 100,
+           press / 100, press % 100, hum / 100, hum % 100);
+    if (d->lost && !history) printf("  (lost %lu)", d->lost);
+    printf("\n");
+    fflush(stdout);
+
+    if (d->csv && !history) {   // il CSV contiene solo la telemetria dal vivo
+        fprintf(d->csv, "%u,%lu,%s%d.%02d,%lu,%u.%02u\n",
+                seq, ms, (temp < 0 ? "-" : ""), abs(temp) / 100, abs(temp) % 100,
+                press, hum / 100, hum % 100);
+        fflush(d->csv);
+    }
+}
+
+/* ------------------------------------------------------------
+   telem_feed()
+   Fuori da un pacchetto i byte sono testo; 0x00 apre un
+   pacchetto, il successivo 0x00 lo chiude
+------------------------------------------------------------ */
+void telem_feed(telem_decoder_t *d, const unsigned char *data, size_t n) {
+    size_t text_start = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        unsigned char c = data[i];
+
+        if (!d->in_frame) {
+            if (c != 0) continue;
+            if (i > text_start && write(STDOUT_FILENO, data + text_start, i - text_start) < 0)
+                perror("write");
+            d->in_frame = 1;
+            d->len = 0;
+        } else if (c == 0) {
+            if (d->len == 0) continue;       // delimitatori consecutivi
+            telem_frame(d);
+            d->in_frame = 0;
+            text_start = i + 1;
+        } else if (d->len < sizeof(d->buf)) {
+            d->buf[d->len++] = c;
+        } else {
+            d->bad++;                        // troppo lungo: non è un pacchetto
+            d->in_frame = 0;
+            text_start = i + 1;
+        }
+    }
+
+    if (!d->in_frame && n > text_start &&
+        write(STDOUT_FILENO, data + text_start, n - text_start) < 0)
+        perror("write");
+    fflush(stdout);
+}
+
 /* ------------------------------------------------------------
    main()
    Programma principale del client seriale.
    Permette di comunicare con il proxy Arduino tramite terminale.
    Funzioni principali:
    - Connessione alla porta seriale indicata
+   - Negoziazione della velocità massima ("auto")
    - Lettura e scrittura simultanee (con poll)
+   - Decodifica della telemetria binaria ed esportazione CSV
 ------------------------------------------------------------ */
 int main(int argc, const char** argv) {
     if (argc < 3) {
-        printf("Usage: client <serial_device> <baudrate>\n");
+        printf("Usage: client <serial_device> <baudrate|auto> [csv_file]\n");
         return 1;
     }
 
     const char* device = argv[1];
-    int baudrate = atoi(argv[2]);
+    int negotiate = !strcmp(argv[2], "auto");
+    int baudrate = negotiate ? SERIAL_BASE_BAUD : atoi(argv[2]);
+
+    telem_decoder_t telem;
+    memset(&telem, 0, sizeof(telem));
+    if (argc > 3) {
+        telem.csv = fopen(argv[3], "a");
+        if (!telem.csv) {
+            perror("fopen");
+            return 1;
+        }
+        if (ftell(telem.csv) == 0)   // intestazione solo per un file nuovo
+            fprintf(telem.csv, "seq,ms,temperature_c,pressure_pa,humidity_rh\n");
+    }
 
     int fd = serial_open(device);
-    serial_set_interface_attribs(fd, baudrate);
+    if (serial_set_interface_attribs(fd, baudrate) != 0) return 1;
+    if (negotiate) baudrate = serial_negotiate(fd);
 
     printf("Connected to %s @ %d baud\n", device, baudrate);
     printf("Type and press Enter to send. Ctrl+C to exit.\n");
@@ -122,17 +383,13 @@ int main(int argc, const char** argv) {
 
         /* ----------------------------------------------------
            Input dalla seriale → stampa sul terminale
-           Tutto ciò che Arduino invia viene visualizzato
-           direttamente, senza modifiche.
+           Il testo inviato da Arduino viene visualizzato
+           senza modifiche, i pacchetti binari decodificati.
         ---------------------------------------------------- */
         if (fds[1].revents & POLLIN) {
-            char buf[256];
+            unsigned char buf[256];
             int n = read(fd, buf, sizeof(buf));
-            if (n > 0) {
-                ssize_t written = write(STDOUT_FILENO, buf, n);
-                if (written < 0) perror("write"); 
-                fflush(stdout);
-            }
+            if (n > 0) telem_feed(&telem, buf, n);
         }
     }
 
@@ -140,6 +397,7 @@ int main(int argc, const char** argv) {
        Chiusura della connessione seriale
     -------------------------------------------------------- */
     close(fd);
+    if (telem.csv) fclose(telem.csv);
     return 0;
 }
 
@@ -14,7 +14,65 @@
 ------------------------------------------------------------ */
 int serial_set_interface_attribs(int fd, int speed);
 
+/* ------------------------------------------------------------
+   Imposta una velocità arbitraria (termios2 / BOTHER, baud.c)
+------------------------------------------------------------ */
+int serial_set_baud(int fd, int speed);
+
 /* ------------------------------------------------------------
    Apre il dispositivo seriale in lettura/scrittura
 ------------------------------------------------------------ */
 int serial_open(const char* device);
+
+/* ------------------------------------------------------------
+   Negoziazione della velocità con il firmware
+   Si parte da SERIAL_BASE_BAUD (UART_BAUD del firmware) e si
+   prova ogni velocità di serial_rates[], dalla più alta:
+   "baud N" → "BAUD N OK", cambio locale, "ping" → "pong".
+   Senza conferma il firmware torna da solo alla velocità base
+   dopo 1 s. Ritorna la velocità raggiunta
+------------------------------------------------------------ */
+#define SERIAL_BASE_BAUD   19200
+#define SERIAL_REVERT_MS   1200   // > PROXY_BAUD_CONFIRM_MS del firmware
+
+int serial_negotiate(int fd);
+
+/* ------------------------------------------------------------
+   Telemetria binaria (formato in src/telemetry/telemetry.h):
+   pacchetti COBS delimitati da 0x00, intercalati al testo
+------------------------------------------------------------ */
+#define TELEM_TYPE_SAMPLE 0x01
+#define TELEM_TYPE_BUCKET 0x02
+#define TELEM_TYPE_RAW    0x03
+#define TELEM_TYPE_EVENT  0x04
+#define TELEM_SAMPLE_LEN  17
+#define TELEM_BUCKET_LEN  28
+#define TELEM_EVENT_LEN   13
+#define TELEM_BUF_SIZE   64
+
+typedef struct {
+    int           in_frame;              // 1 dopo un delimitatore 0x00
+    unsigned char buf[TELEM_BUF_SIZE];  // pacchetto codificato in arrivo
+    size_t        len;
+    int           have_seq;
+    unsigned      last_seq;
+    unsigned long lost;                  // report mancanti (salti di sequenza)
+    unsigned long bad;                   // pacchetti scartati (COBS o CRC)
+    FILE         *csv;                   // esportazione, NULL se disattivata
+} telem_decoder_t;
+
+/* ------------------------------------------------------------
+   Decodifica COBS; ritorna la lunghezza decodificata o -1
+------------------------------------------------------------ */
+int cobs_decode(const unsigned char *in, size_t len, unsigned char *out);
+
+/* ------------------------------------------------------------
+   CRC-16 CCITT (init 0xFFFF), come _crc_ccitt_update() avr-libc
+------------------------------------------------------------ */
+unsigned short crc16_ccitt(const unsigned char *data, size_t len);
+
+/* ------------------------------------------------------------
+   Elabora i byte ricevuti: il testo va su stdout, i pacchetti
+   validi vengono stampati ed eventualmente esportati in CSV
+------------------------------------------------------------ */
+void telem_feed(telem_decoder_t *d, const unsigned char *data, size_t n);
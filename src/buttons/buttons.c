@@ -1,33 +1,170 @@
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+
 #include "buttons.h"
 
+/* ------------------------------------------------------------
+   Interrupt esterni associati a PD2/PD3
+------------------------------------------------------------ */
+#if defined(__AVR_ATmega2560__)
+#define BTN_SELECT_INT   INT2
+#define BTN_CONFIRM_INT  INT3
+#define BTN_EICRA_ANY    ((1 << ISC20) | (1 << ISC30))   // qualsiasi fronte
+#define BTN_SELECT_VECT  INT2_vect
+#define BTN_CONFIRM_VECT INT3_vect
+#else
+#define BTN_SELECT_INT   INT0
+#define BTN_CONFIRM_INT  INT1
+#define BTN_EICRA_ANY    ((1 << ISC00) | (1 << ISC10))
+#define BTN_SELECT_VECT  INT0_vect
+#define BTN_CONFIRM_VECT INT1_vect
+#endif
+
+#define BTN_COUNT 2
+#define BTN_QUEUE_MASK (BTN_EVENT_QUEUE - 1)
+
+/* ------------------------------------------------------------
+   Stato della macchina a stati di debounce (solo ISR)
+------------------------------------------------------------ */
+typedef struct {
+    uint8_t  pin;        // bit in PIND
+    uint8_t  pressed;    // stato stabile (1 = premuto)
+    uint8_t  cnt;        // ms consecutivi con lettura diversa dallo stato stabile
+    uint16_t held_ms;    // durata della pressione corrente
+} BTN_state_t;
+
+static BTN_state_t btn[BTN_COUNT] = {
+    { BTN_SELECT_PIN,  0, 0, 0 },
+    { BTN_CONFIRM_PIN, 0, 0, 0 },
+};
+
+/* ------------------------------------------------------------
+   Coda degli eventi (prodotta dalla ISR, consumata dal proxy)
+   Ogni evento è codificato in un byte: (pulsante << 4) | tipo
+------------------------------------------------------------ */
+static volatile uint8_t evt_buf[BTN_EVENT_QUEUE];
+static volatile uint8_t evt_head = 0, evt_tail = 0;
+
+static void BUTTONS_push(uint8_t button, uint8_t type) {
+    uint8_t next = (evt_head + 1) & BTN_QUEUE_MASK;
+    if (next == evt_tail) return;   // coda piena: evento scartato
+    evt_buf[evt_head] = (button << 4) | type;
+    evt_head = next;
+}
+
+/* ------------------------------------------------------------
+   Timer0 di debounce: CTC a 1 kHz (F_CPU / 64 / 250)
+------------------------------------------------------------ */
+static void BUTTONS_timer_start(void) {
+    if (TIMSK0 & (1 << OCIE0A)) return;   // già attivo
+    TCNT0  = 0;
+    TIFR0  = (1 << OCF0A);
+    TIMSK0 = (1 << OCIE0A);
+    TCCR0B = (1 << CS01) | (1 << CS00);   // prescaler 64
+}
+
+static void BUTTONS_timer_stop(void) {
+    TCCR0B = 0;
+    TIMSK0 = 0;
+}
+
 /* ------------------------------------------------------------
    Inizializzazione dei pin dei pulsanti
    - Usa INPUT_PULLUP → logica inversa (premuto = 0)
+   - Interrupt su qualsiasi fronte per avviare il debounce
 ------------------------------------------------------------ */
 void BUTTONS_init(void) {
     DDRD &= ~((1 << BTN_SELECT_PIN) | (1 << BTN_CONFIRM_PIN)); // 0 = input
     PORTD |= (1 << BTN_SELECT_PIN) | (1 << BTN_CONFIRM_PIN);   // pull-up attivi
+
+    TCCR0A = (1 << WGM01);                // CTC, TOP = OCR0A
+    OCR0A  = (F_CPU / 64 / 1000UL) - 1;
+
+    EICRA |= BTN_EICRA_ANY;
+    EIFR   = (1 << BTN_SELECT_INT) | (1 << BTN_CONFIRM_INT);
+    EIMSK |= (1 << BTN_SELECT_INT) | (1 << BTN_CONFIRM_INT);
+
+    sei();
+}
+
+/* ------------------------------------------------------------
+   BUTTONS_get_event()
+   Estrae il prossimo evento dalla coda
+------------------------------------------------------------ */
+uint8_t BUTTONS_get_event(BUTTONS_event_t *e) {
+    uint8_t v;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        if (evt_head == evt_tail) return 0;
+        v = evt_buf[evt_tail];
+        evt_tail = (evt_tail + 1) & BTN_QUEUE_MASK;
+    }
+    e->button = v >> 4;
+    e->type   = v & 0x0F;
+    return 1;
 }
 
 /* ------------------------------------------------------------
-   Lettura con debounce 
-   Ritorna:
+   BUTTONS_read()
+   Ritorna il prossimo pulsante premuto:
      1 = select
      2 = confirm
      0 = nessuno
 ------------------------------------------------------------ */
 uint8_t BUTTONS_read(void) {
-    if (!(PIND & (1 << BTN_SELECT_PIN))) {  // Vero se premuto, (pin a 0)
-        _delay_ms(30); // debounce
-        if (!(PIND & (1 << BTN_SELECT_PIN))) return 1;
+    BUTTONS_event_t e;
+    while (BUTTONS_get_event(&e)) {
+        if (e.type == BTN_EVT_PRESS) return e.button;
     }
+    return 0;
+}
 
-    if (!(PIND & (1 << BTN_CONFIRM_PIN))) {
-        _delay_ms(30);
-        if (!(PIND & (1 << BTN_CONFIRM_PIN))) return 2;
-    }
+/* ------------------------------------------------------------
+   ISR: interrupt esterni dei pulsanti
+   Un fronte (anche dovuto ai rimbalzi) avvia solo il timer:
+   la decisione spetta alla macchina a stati di debounce
+------------------------------------------------------------ */
+ISR(BTN_SELECT_VECT) {
+    BUTTONS_timer_start();
+}
 
-    return 0;
+ISR(BTN_CONFIRM_VECT) {
+    BUTTONS_timer_start();
 }
 
+/* ------------------------------------------------------------
+   ISR: tick di debounce (TIMER0_COMPA_vect), ogni 1 ms
+   Un cambio di stato è accettato dopo BTN_DEBOUNCE_MS letture
+   consecutive coerenti. Il timer si ferma quando entrambi i
+   pulsanti sono stabili e rilasciati.
+------------------------------------------------------------ */
+ISR(TIMER0_COMPA_vect) {
+    uint8_t busy = 0;
+
+    for (uint8_t i = 0; i < BTN_COUNT; i++) {
+        BTN_state_t *b = &btn[i];
+        uint8_t raw = !(PIND & (1 << b->pin));
 
+        if (raw != b->pressed) {
+            if (++b->cnt >= BTN_DEBOUNCE_MS) {
+                b->pressed = raw;
+                b->cnt = 0;
+                if (raw) {
+                    b->held_ms = 0;
+                    BUTTONS_push(i + 1, BTN_EVT_PRESS);
+                } else {
+                    BUTTONS_push(i + 1, BTN_EVT_RELEASE);
+                }
+            }
+        } else {
+            b->cnt = 0;
+        }
+
+        if (b->pressed && b->held_ms < BTN_LONG_MS) {
+            if (++b->held_ms == BTN_LONG_MS) BUTTONS_push(i + 1, BTN_EVT_LONG);
+        }
+
+        if (b->pressed || b->cnt) busy = 1;
+    }
+
+    if (!busy) BUTTONS_timer_stop();
+}
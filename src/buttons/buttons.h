@@ -2,7 +2,6 @@
 
 #include <stdint.h>
 #include <avr/io.h>
-#include <util/delay.h>
 
 /* ------------------------------------------------------------
    Definizione pin dei pulsanti
@@ -10,17 +9,52 @@
 #define BTN_SELECT_PIN PD2   // Pulsante per scorrere i parametri
 #define BTN_CONFIRM_PIN PD3  // Pulsante per confermare la scelta
 
+/* ------------------------------------------------------------
+   Identificativi dei pulsanti (coincidono con BUTTONS_read())
+------------------------------------------------------------ */
+#define BTN_SELECT  1
+#define BTN_CONFIRM 2
+
+/* ------------------------------------------------------------
+   Parametri del debounce (ms)
+------------------------------------------------------------ */
+#define BTN_DEBOUNCE_MS   20    // stato stabile per questo tempo
+#define BTN_LONG_MS       800   // pressione lunga
+#define BTN_EVENT_QUEUE   8     // potenza di 2
+
+/* ------------------------------------------------------------
+   Eventi generati dalla macchina a stati di debounce
+------------------------------------------------------------ */
+typedef enum {
+    BTN_EVT_PRESS   = 1,   // pressione (dopo il debounce)
+    BTN_EVT_LONG    = 2,   // tenuto premuto per BTN_LONG_MS
+    BTN_EVT_RELEASE = 3    // rilascio
+} BUTTONS_event_type_t;
+
+typedef struct {
+    uint8_t button;   // BTN_SELECT o BTN_CONFIRM
+    uint8_t type;     // BUTTONS_event_type_t
+} BUTTONS_event_t;
+
 /* ------------------------------------------------------------
    Inizializzazione dei pulsanti
+   Interrupt esterni sui pin (INT2/INT3 su Mega, INT0/INT1 su Uno)
+   e Timer0 a 1 ms per il debounce, attivo solo mentre
+   almeno un pulsante non è a riposo.
 ------------------------------------------------------------ */
 void BUTTONS_init(void);
 
 /* ------------------------------------------------------------
-   Legge lo stato dei pulsanti 
-   Ritorna:
+   Estrae il prossimo evento dalla coda (non bloccante)
+   Ritorna 1 se un evento è stato estratto, 0 se la coda è vuota
+------------------------------------------------------------ */
+uint8_t BUTTONS_get_event(BUTTONS_event_t *e);
+
+/* ------------------------------------------------------------
+   Legge il prossimo evento di pressione (non bloccante)
+   Scarta gli altri eventi. Ritorna:
      1 se BTN_SELECT premuto
      2 se BTN_CONFIRM premuto
      0 se nessuno
 ------------------------------------------------------------ */
 uint8_t BUTTONS_read(void);
-
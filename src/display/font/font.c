@@ -3,8 +3,9 @@
 /* ------------------------------------------------------------
    Font 5x7 ASCII (32..126)
    Ogni carattere: 5 colonne + 1 spazio
+   In PROGMEM: non occupa SRAM
 ------------------------------------------------------------ */
-const uint8_t OLED_font5x7[] = {
+const uint8_t OLED_font5x7[] PROGMEM = {
     0x00,0x00,0x00,0x00,0x00, 0x00,0x00,0x5F,0x00,0x00, 0x00,0x07,0x00,0x07,0x00,
   0x14,0x7F,0x14,0x7F,0x14, 0x24,0x2A,0x7F,0x2A,0x12, 0x23,0x13,0x08,0x64,0x62,
   0x36,0x49,0x55,0x22,0x50, 0x00,0x05,0x03,0x00,0x00, 0x00,0x1C,0x22,0x41,0x00,
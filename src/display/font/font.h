@@ -1,10 +1,12 @@
 #pragma once
 
 #include <stdint.h>
+#include <avr/pgmspace.h>
 
 /* ------------------------------------------------------------
    Font 5x7 per OLED (ASCII 32..126)
+   Memorizzato in flash: leggere con pgm_read_byte()
 ------------------------------------------------------------ */
-extern const uint8_t OLED_font5x7[];
+extern const uint8_t OLED_font5x7[] PROGMEM;
 
 
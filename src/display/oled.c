@@ -1,19 +1,95 @@
 #include <util/delay.h>
 #include <string.h>
+#include <avr/pgmspace.h>
 
 #include "../../avr_common/i2c/i2c.h"
 #include "font/font.h"
 #include "oled.h"
 
 /* ------------------------------------------------------------
-   Funzioni interne (comandi e dati I2C)
+   Byte di controllo SH1106
 ------------------------------------------------------------ */
-static void OLED_command(uint8_t cmd) {
-    I2C_write_reg(OLED_ADDR, 0x00, cmd); // invia comando
+#define OLED_CTRL_CMD  0x00   // seguono solo comandi
+#define OLED_CTRL_DATA 0x40   // seguono solo dati (GDDRAM)
+
+/* ------------------------------------------------------------
+   Sequenza di inizializzazione SH1106 (inviata in blocco)
+------------------------------------------------------------ */
+static const uint8_t oled_init_seq[] PROGMEM = {
+    0xAE,           // display off
+    0xD5, 0x80,
+    0xA8, 0x3F,
+    0xD3, 0x00,
+    0x40,
+    0xAD, 0x8B,
+    0xA1,
+    0xC8,
+    0xDA, 0x12,
+    0x81, 0x80,
+    0xD9, 0x22,
+    0xDB, 0x35,
+    0xA4,
+    0xA6,
+    0xAF            // display on
+};
+
+/* ------------------------------------------------------------
+   OLED_command_seq()
+   Invia più comandi in un'unica transazione I2C
+------------------------------------------------------------ */
+void OLED_command_seq(const uint8_t *cmds, uint8_t n) {
+    I2C_write_bulk(OLED_ADDR, OLED_CTRL_CMD, cmds, n);
+}
+
+/* ------------------------------------------------------------
+   Funzioni interne
+------------------------------------------------------------ */
+// Posiziona il cursore su pagina e colonna (offset SH1106 di 2 colonne)
+static void OLED_set_pos(uint8_t page, uint8_t col) {
+    uint8_t cmds[3];
+    col += 2;
+    cmds[0] = 0xB0 + page;
+    cmds[1] = 0x00 | (col & 0x0F);
+    cmds[2] = 0x10 | (col >> 4);
+    OLED_command_seq(cmds, sizeof(cmds));
+}
+
+/* ------------------------------------------------------------
+   Framebuffer in SRAM (8 pagine × 128 colonne = 1 KB)
+   Per ogni pagina si tiene l'intervallo di colonne modificate
+   [dirty_lo, dirty_hi]; dirty_lo > dirty_hi indica pagina pulita.
+   Un byte viene marcato solo se il nuovo valore è diverso.
+------------------------------------------------------------ */
+#define OLED_PAGES 8
+#define OLED_COLS  128
+
+static uint8_t fb[OLED_PAGES][OLED_COLS];
+static uint8_t dirty_lo[OLED_PAGES];
+static uint8_t dirty_hi[OLED_PAGES];
+
+/* ------------------------------------------------------------
+   Testo presente in ogni cella di 6 colonne (0 = sconosciuto):
+   ristampare una riga ridisegna solo i caratteri cambiati,
+   senza leggere i glifi né confrontare il framebuffer per le
+   celle invariate. Chi scrive nel framebuffer senza passare dal
+   testo deve azzerare le celle toccate.
+------------------------------------------------------------ */
+static char cells[OLED_PAGES][OLED_CHARS];
+
+static void OLED_mark_clean(uint8_t page) {
+    dirty_lo[page] = OLED_COLS;   // lo > hi: nessuna colonna da inviare
+    dirty_hi[page] = 0;
+}
+
+static void OLED_mark_dirty(uint8_t page, uint8_t lo, uint8_t hi) {
+    if (lo < dirty_lo[page]) dirty_lo[page] = lo;
+    if (hi > dirty_hi[page]) dirty_hi[page] = hi;
 }
 
-static void OLED_data(uint8_t data) {
-    I2C_write_reg(OLED_ADDR, 0x40, data); // invia dato
+static void OLED_put(uint8_t page, uint8_t col, uint8_t val) {
+    if (fb[page][col] == val) return;
+    fb[page][col] = val;
+    OLED_mark_dirty(page, col, col);
 }
 
 /* ------------------------------------------------------------
@@ -24,83 +100,193 @@ static void OLED_data(uint8_t data) {
 void OLED_init(void) {
     _delay_ms(100);
 
-    OLED_command(0xAE); // display off
-    OLED_command(0xD5); OLED_command(0x80);
-    OLED_command(0xA8); OLED_command(0x3F);
-    OLED_command(0xD3); OLED_command(0x00);
-    OLED_command(0x40);
-    OLED_command(0xAD); OLED_command(0x8B); 
-    OLED_command(0xA1); 
-    OLED_command(0xC8);
-    OLED_command(0xDA); OLED_command(0x12);
-    OLED_command(0x81); OLED_command(0x80);
-    OLED_command(0xD9); OLED_command(0x22);
-    OLED_command(0xDB); OLED_command(0x35);
-    OLED_command(0xA4);
-    OLED_command(0xA6);
-    OLED_command(0xAF); // display on
+    uint8_t seq[sizeof(oled_init_seq)];
+    memcpy_P(seq, oled_init_seq, sizeof(seq));
+    OLED_command_seq(seq, sizeof(seq));
+
+    // La GDDRAM all'accensione ha contenuto casuale: va azzerata tutta
+    memset(fb, 0, sizeof(fb));
+    memset(cells, ' ', sizeof(cells));   // il glifo dello spazio è vuoto
+    for (uint8_t page = 0; page < OLED_PAGES; page++) {
+        OLED_mark_clean(page);
+        OLED_mark_dirty(page, 0, OLED_COLS - 1);
+    }
+    OLED_flush();
+}
+
+/* ------------------------------------------------------------
+   OLED_flush_step()
+   Invia al più max_bytes colonne modificate di una pagina (una
+   transazione comandi + una dati) e ritorna OLED_FLUSH_MORE se
+   resta altro da inviare, OLED_FLUSH_ERROR se l'I2C fallisce. Il framebuffer fa da coda: più modifiche alla stessa
+   zona prima dell'invio si fondono e parte solo il contenuto più
+   recente. Le pagine sono servite a turno, così una zona che
+   cambia di continuo non blocca le altre.
+------------------------------------------------------------ */
+static uint8_t flush_page = 0;   // prossima pagina da servire
+
+static uint8_t OLED_pending(void) {
+    for (uint8_t page = 0; page < OLED_PAGES; page++)
+        if (dirty_lo[page] <= dirty_hi[page]) return 1;
+    return 0;
+}
+
+uint8_t OLED_flush_step(uint8_t max_bytes) {
+    for (uint8_t i = 0; i < OLED_PAGES; i++) {
+        uint8_t page = flush_page;
+        uint8_t lo = dirty_lo[page];
+        uint8_t hi = dirty_hi[page];
+        if (lo > hi) {
+            flush_page = (page + 1) % OLED_PAGES;
+            continue;
+        }
+        if (max_bytes && hi - lo >= max_bytes) hi = lo + max_bytes - 1;
+
+        OLED_set_pos(page, lo);
+        if (I2C_stream_begin(OLED_ADDR, OLED_CTRL_DATA)) return OLED_FLUSH_ERROR;   // la pagina resta sporca
+        for (uint8_t col = lo; col <= hi; col++) {
+            I2C_stream_write(fb[page][col]);
+        }
+        I2C_stream_end();
+
+        if (hi == dirty_hi[page]) {
+            OLED_mark_clean(page);
+            flush_page = (page + 1) % OLED_PAGES;
+        } else {
+            dirty_lo[page] = hi + 1;   // il resto della pagina al prossimo passo
+        }
+        return OLED_pending() ? OLED_FLUSH_MORE : OLED_FLUSH_DONE;
+    }
+    return OLED_FLUSH_DONE;
+}
 
-    OLED_clear();
+/* ------------------------------------------------------------
+   OLED_flush()
+   Invia subito tutte le colonne modificate (bloccante: per
+   l'avvio e l'uscita; durante il funzionamento OLED_flush_step())
+------------------------------------------------------------ */
+void OLED_flush(void) {
+    // Un passo per pagina: con un errore I2C la pagina resta
+    // sporca e si riprova al flush successivo
+    for (uint8_t i = 0; i < OLED_PAGES && OLED_flush_step(0) == OLED_FLUSH_MORE; i++);
 }
 
 /* ------------------------------------------------------------
    OLED_clear()
-   Pulisce lo schermo (8 pagine × 128 colonne)
+   Pulisce il framebuffer (8 pagine × 128 colonne)
 ------------------------------------------------------------ */
 void OLED_clear(void) {
-    for (uint8_t page = 0; page < 8; page++) {
-        OLED_command(0xB0 + page);
-        OLED_command(0x02);
-        OLED_command(0x10);
-        for (uint8_t col = 0; col < 128; col++) {
-            OLED_data(0x00);
+    for (uint8_t page = 0; page < OLED_PAGES; page++) {
+        for (uint8_t col = 0; col < OLED_COLS; col++) {
+            OLED_put(page, col, 0x00);
         }
     }
+    memset(cells, ' ', sizeof(cells));
 }
 
 /* ------------------------------------------------------------
-   OLED_print_line()
-   Scrive testo su una riga (pagina 0–7)
+   OLED_render_line()
+   Scrive testo su una riga (pagina 0–7) del framebuffer a
+   partire dal carattere x (colonne di 6 pixel), ridisegnando
+   solo le celle il cui carattere è cambiato.
+   Con clear = 1 le celle dopo il testo diventano spazi: la
+   riga viene sempre riscritta per intero, senza bisogno di
+   OLED_clear().
+   progmem: 1 se text è in flash (PSTR)
 ------------------------------------------------------------ */
-void OLED_print_line(uint8_t line, const char *text) {
+static void OLED_render_line(uint8_t line, uint8_t x, const char *text,
+                             uint8_t progmem, uint8_t clear) {
     if (line > 7) return;
 
-    OLED_command(0xB0 + line);
-    OLED_command(0x02);
-    OLED_command(0x10);
-
-    while (*text) {
-        char c = *text++;
+    for (; x < OLED_CHARS; x++) {
+        char c = progmem ? (char)pgm_read_byte(text) : *text;
+        if (c) text++;
+        else if (clear) c = ' ';
+        else return;
         if (c < 32 || c > 126) c = '?';
+        if (cells[line][x] == c) continue;
+        cells[line][x] = c;
+
         const uint8_t *glyph = &OLED_font5x7[(c - 32) * 5];
-        for (uint8_t i = 0; i < 5; i++) OLED_data(glyph[i]);
-        OLED_data(0x00);
+        uint8_t col = x * 6;
+        for (uint8_t i = 0; i < 5; i++) OLED_put(line, col + i, pgm_read_byte(&glyph[i]));
+        OLED_put(line, col + 5, 0x00);
     }
+    if (clear)
+        for (uint8_t col = OLED_CHARS * 6; col < OLED_COLS; col++) OLED_put(line, col, 0x00);
 }
 
 /* ------------------------------------------------------------
-   OLED_show_sensor()
-   Mostra un solo valore (temp, press o hum)
+   OLED_print_line() / OLED_print_line_P()
+   Scrive testo in SRAM / in flash su una riga
 ------------------------------------------------------------ */
-void OLED_show_sensor(const char* temp, const char* press, const char* hum) {
-    OLED_clear();
-    if (temp)  { OLED_print_line(3, temp);  return; }
-    if (press) { OLED_print_line(3, press); return; }
-    if (hum)   { OLED_print_line(3, hum);   return; }
+void OLED_print_line(uint8_t line, const char *text) {
+    OLED_render_line(line, 0, text, 0, 1);
+}
+
+void OLED_print_line_P(uint8_t line, const char *text) {
+    OLED_render_line(line, 0, text, 1, 1);
 }
 
 /* ------------------------------------------------------------
-   OLED_show_sensors()
-   Mostra tre valori su linee 1, 3 e 5
+   OLED_print_at()
+   Scrive testo dal carattere x senza toccare il resto della riga
 ------------------------------------------------------------ */
-void OLED_show_sensors(const char *temp, const char *press, const char *hum) {
-    OLED_clear();
-    OLED_print_line(1, temp); 
-    OLED_print_line(3, press);
-    OLED_print_line(5, hum);
+void OLED_print_at(uint8_t line, uint8_t x, const char *text) {
+    OLED_render_line(line, x, text, 0, 0);
 }
 
+/* ------------------------------------------------------------
+   OLED_blit_P()
+   Copia una bitmap pre-renderizzata (una pagina, width byte in
+   flash) all'inizio di una riga e azzera il resto: nessuna
+   ricerca di glifi, solo il confronto byte a byte con il
+   framebuffer. Il testo della riga non è più noto alle celle.
+------------------------------------------------------------ */
+void OLED_blit_P(uint8_t line, const uint8_t *bmp, uint8_t width) {
+    if (line > 7) return;
+
+    uint8_t col = 0;
+    while (col < width && col < OLED_COLS) OLED_put(line, col++, pgm_read_byte(bmp++));
+    while (col < OLED_COLS) OLED_put(line, col++, 0x00);
+    memset(cells[line], 0, OLED_CHARS);
+}
 
+/* ------------------------------------------------------------
+   OLED_put_column()
+   Scrive n byte verticali nella colonna col a partire dalla
+   pagina page (grafici): solo i byte cambiati vengono inviati
+------------------------------------------------------------ */
+void OLED_put_column(uint8_t col, uint8_t page, const uint8_t *bytes, uint8_t n) {
+    if (col >= OLED_COLS) return;
 
+    for (uint8_t i = 0; i < n && page < OLED_PAGES; i++, page++) {
+        OLED_put(page, col, bytes[i]);
+        if (col / 6 < OLED_CHARS) cells[page][col / 6] = 0;
+    }
+}
 
+/* ------------------------------------------------------------
+   OLED_show_sensor()
+   Mostra un solo valore (temp, press o hum) sulla riga 3
+------------------------------------------------------------ */
+void OLED_show_sensor(const char* temp, const char* press, const char* hum) {
+    const char *text = temp ? temp : press ? press : hum ? hum : "";
+    for (uint8_t line = 0; line < OLED_PAGES; line++) {
+        OLED_print_line(line, (line == 3) ? text : "");
+    }
+}
 
+/* ------------------------------------------------------------
+   OLED_show_sensors()
+   Mostra tre valori su linee 1, 3 e 5
+------------------------------------------------------------ */
+void OLED_show_sensors(const char *temp, const char *press, const char *hum) {
+    for (uint8_t line = 0; line < OLED_PAGES; line++) {
+        const char *text = "";
+        if (line == 1) text = temp;
+        else if (line == 3) text = press;
+        else if (line == 5) text = hum;
+        OLED_print_line(line, text);
+    }
+}
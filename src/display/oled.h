@@ -13,10 +13,52 @@
 void OLED_init(void);
 void OLED_clear(void);
 
+// Invia una sequenza di comandi in un'unica transazione I2C
+void OLED_command_seq(const uint8_t *cmds, uint8_t n);
+
+/* ------------------------------------------------------------
+   Le funzioni di disegno scrivono solo nel framebuffer in SRAM:
+   OLED_flush() invia al display le colonne effettivamente cambiate
+------------------------------------------------------------ */
+void OLED_flush(void);
+
+/* ------------------------------------------------------------
+   Invio a blocchi, per non fermare il ciclo principale:
+   OLED_flush_step() invia al più max_bytes colonne di una
+   pagina (0 = pagina intera) e ritorna OLED_FLUSH_MORE se
+   resta altro, OLED_FLUSH_ERROR se il display non risponde
+   (la pagina resta da inviare)
+------------------------------------------------------------ */
+#ifndef OLED_FLUSH_CHUNK
+#define OLED_FLUSH_CHUNK 32   // ~1 ms a 400 kHz
+#endif
+
+#define OLED_FLUSH_DONE  0
+#define OLED_FLUSH_MORE  1
+#define OLED_FLUSH_ERROR 2
+
+uint8_t OLED_flush_step(uint8_t max_bytes);
+
 /* ------------------------------------------------------------
-   Stampa testo su riga (0–7)
+   Stampa testo su riga (0–7), azzerando il resto della riga
+   Solo i caratteri diversi da quelli già presenti vengono
+   ridisegnati (e quindi inviati da OLED_flush())
 ------------------------------------------------------------ */
 void OLED_print_line(uint8_t line, const char *text);
+void OLED_print_line_P(uint8_t line, const char *text);   // text in flash (PSTR)
+
+// Testo dal carattere x (0–20), il resto della riga resta invariato
+#define OLED_CHARS 21
+void OLED_print_at(uint8_t line, uint8_t x, const char *text);
+
+/* ------------------------------------------------------------
+   Disegna una riga pre-renderizzata in flash (display/screens.h,
+   generato da tools/screens), azzerando il resto della riga
+------------------------------------------------------------ */
+void OLED_blit_P(uint8_t line, const uint8_t *bmp, uint8_t width);
+
+// n byte verticali (bit 0 in alto) nella colonna col, dalla pagina page
+void OLED_put_column(uint8_t col, uint8_t page, const uint8_t *bytes, uint8_t n);
 
 /* ------------------------------------------------------------
    Visualizzazione valore sensori
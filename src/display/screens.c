@@ -0,0 +1,165 @@
+/* ------------------------------------------------------------
+   File generato da tools/screens/mkscreens: non modificare
+------------------------------------------------------------ */
+
+#include "screens.h"
+
+// "SELECT PARAMETER:"
+const uint8_t SCREENS_menu_title[SCREENS_MENU_TITLE_W] PROGMEM = {
+    0x46,0x49,0x49,0x49,0x31,0x00,0x7F,0x49,0x49,0x49,0x41,0x00,0x7F,0x40,0x40,0x40,
+    0x40,0x00,0x7F,0x49,0x49,0x49,0x41,0x00,0x3E,0x41,0x41,0x41,0x22,0x00,0x01,0x01,
+    0x7F,0x01,0x01,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0x09,0x09,0x09,0x06,0x00,
+    0x7E,0x11,0x11,0x11,0x7E,0x00,0x7F,0x09,0x19,0x29,0x46,0x00,0x7E,0x11,0x11,0x11,
+    0x7E,0x00,0x7F,0x02,0x0C,0x02,0x7F,0x00,0x7F,0x49,0x49,0x49,0x41,0x00,0x01,0x01,
+    0x7F,0x01,0x01,0x00,0x7F,0x49,0x49,0x49,0x41,0x00,0x7F,0x09,0x19,0x29,0x46,0x00,
+    0x00,0x36,0x36,
+};
+
+// "       WELCOME!"
+const uint8_t SCREENS_welcome[SCREENS_WELCOME_W] PROGMEM = {
+    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3F,0x40,0x38,0x40,0x3F,0x00,
+    0x7F,0x49,0x49,0x49,0x41,0x00,0x7F,0x40,0x40,0x40,0x40,0x00,0x3E,0x41,0x41,0x41,
+    0x22,0x00,0x3E,0x41,0x41,0x41,0x3E,0x00,0x7F,0x02,0x0C,0x02,0x7F,0x00,0x7F,0x49,
+    0x49,0x49,0x41,0x00,0x00,0x00,0x5F,
+};
+
+// "     GOODBYE! :)"
+const uint8_t SCREENS_goodbye[SCREENS_GOODBYE_W] PROGMEM = {
+    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+    0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3E,0x41,
+    0x49,0x49,0x7A,0x00,0x3E,0x41,0x41,0x41,0x3E,0x00,0x3E,0x41,0x41,0x41,0x3E,0x00,
+    0x7F,0x41,0x41,0x22,0x1C,0x00,0x7F,0x49,0x49,0x49,0x36,0x00,0x07,0x08,0x70,0x08,
+    0x07,0x00,0x7F,0x49,0x49,0x49,0x41,0x00,0x00,0x00,0x5F,0x00,0x00,0x00,0x00,0x00,
+    0x00,0x00,0x00,0x00,0x00,0x36,0x36,0x00,0x00,0x00,0x00,0x41,0x22,0x1C,
+};
+
+const uint8_t SCREENS_menu[SCREENS_MENU_ITEMS][2][SCREENS_MENU_W] PROGMEM = {
+    {   // Temperature
+        {
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x7F,0x01,0x01,0x00,0x38,0x54,
+            0x54,0x54,0x18,0x00,0x7C,0x04,0x18,0x04,0x78,0x00,0x7C,0x14,0x14,0x14,0x08,0x00,
+            0x38,0x54,0x54,0x54,0x18,0x00,0x7C,0x08,0x04,0x04,0x08,0x00,0x20,0x54,0x54,0x54,
+            0x78,0x00,0x04,0x3F,0x44,0x40,0x20,0x00,0x3C,0x40,0x40,0x20,0x7C,0x00,0x7C,0x08,
+            0x04,0x04,0x08,0x00,0x38,0x54,0x54,0x54,0x18,
+        },
+        {
+            0x08,0x08,0x08,0x08,0x08,0x00,0x08,0x08,0x08,0x08,0x08,0x00,0x00,0x41,0x22,0x14,
+            0x08,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x01,0x01,0x7F,0x01,0x01,0x00,0x38,0x54,
+            0x54,0x54,0x18,0x00,0x7C,0x04,0x18,0x04,0x78,0x00,0x7C,0x14,0x14,0x14,0x08,0x00,
+            0x38,0x54,0x54,0x54,0x18,0x00,0x7C,0x08,0x04,0x04,0x08,0x00,0x20,0x54,0x54,0x54,
+            0x78,0x00,0x04,0x3F,0x44,0x40,0x20,0x00,0x3C,0x40,0x40,0x20,0x7C,0x00,0x7C,0x08,
+            0x04,0x04,0x08,0x00,0x38,0x54,0x54,0x54,0x18,
+        },
+    },
+    {   // Pressure
+        {
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0x09,0x09,0x09,0x06,0x00,0x7C,0x08,
+            0x04,0x04,0x08,0x00,0x38,0x54,0x54,0x54,0x18,0x00,0x48,0x54,0x54,0x54,0x20,0x00,
+            0x48,0x54,0x54,0x54,0x20,0x00,0x3C,0x40,0x40,0x20,0x7C,0x00,0x7C,0x08,0x04,0x04,
+            0x08,0x00,0x38,0x54,0x54,0x54,0x18,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+        },
+        {
+            0x08,0x08,0x08,0x08,0x08,0x00,0x08,0x08,0x08,0x08,0x08,0x00,0x00,0x41,0x22,0x14,
+            0x08,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0x09,0x09,0x09,0x06,0x00,0x7C,0x08,
+            0x04,0x04,0x08,0x00,0x38,0x54,0x54,0x54,0x18,0x00,0x48,0x54,0x54,0x54,0x20,0x00,
+            0x48,0x54,0x54,0x54,0x20,0x00,0x3C,0x40,0x40,0x20,0x7C,0x00,0x7C,0x08,0x04,0x04,
+            0x08,0x00,0x38,0x54,0x54,0x54,0x18,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+        },
+    },
+    {   // Humidity
+        {
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0x08,0x08,0x08,0x7F,0x00,0x3C,0x40,
+            0x40,0x20,0x7C,0x00,0x7C,0x04,0x18,0x04,0x78,0x00,0x00,0x44,0x7D,0x40,0x00,0x00,
+            0x38,0x44,0x44,0x48,0x7F,0x00,0x00,0x44,0x7D,0x40,0x00,0x00,0x04,0x3F,0x44,0x40,
+            0x20,0x00,0x0C,0x50,0x50,0x50,0x3C,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+        },
+        {
+            0x08,0x08,0x08,0x08,0x08,0x00,0x08,0x08,0x08,0x08,0x08,0x00,0x00,0x41,0x22,0x14,
+            0x08,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0x08,0x08,0x08,0x7F,0x00,0x3C,0x40,
+            0x40,0x20,0x7C,0x00,0x7C,0x04,0x18,0x04,0x78,0x00,0x00,0x44,0x7D,0x40,0x00,0x00,
+            0x38,0x44,0x44,0x48,0x7F,0x00,0x00,0x44,0x7D,0x40,0x00,0x00,0x04,0x3F,0x44,0x40,
+            0x20,0x00,0x0C,0x50,0x50,0x50,0x3C,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+        },
+    },
+    {   // All
+        {
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7E,0x11,0x11,0x11,0x7E,0x00,0x00,0x41,
+            0x7F,0x40,0x00,0x00,0x00,0x41,0x7F,0x40,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+        },
+        {
+            0x08,0x08,0x08,0x08,0x08,0x00,0x08,0x08,0x08,0x08,0x08,0x00,0x00,0x41,0x22,0x14,
+            0x08,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7E,0x11,0x11,0x11,0x7E,0x00,0x00,0x41,
+            0x7F,0x40,0x00,0x00,0x00,0x41,0x7F,0x40,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+        },
+    },
+    {   // Stats
+        {
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x46,0x49,0x49,0x49,0x31,0x00,0x04,0x3F,
+            0x44,0x40,0x20,0x00,0x20,0x54,0x54,0x54,0x78,0x00,0x04,0x3F,0x44,0x40,0x20,0x00,
+            0x48,0x54,0x54,0x54,0x20,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+        },
+        {
+            0x08,0x08,0x08,0x08,0x08,0x00,0x08,0x08,0x08,0x08,0x08,0x00,0x00,0x41,0x22,0x14,
+            0x08,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x46,0x49,0x49,0x49,0x31,0x00,0x04,0x3F,
+            0x44,0x40,0x20,0x00,0x20,0x54,0x54,0x54,0x78,0x00,0x04,0x3F,0x44,0x40,0x20,0x00,
+            0x48,0x54,0x54,0x54,0x20,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+        },
+    },
+    {   // Graph
+        {
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3E,0x41,0x49,0x49,0x7A,0x00,0x7C,0x08,
+            0x04,0x04,0x08,0x00,0x20,0x54,0x54,0x54,0x78,0x00,0x7C,0x14,0x14,0x14,0x08,0x00,
+            0x7F,0x08,0x04,0x04,0x78,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+        },
+        {
+            0x08,0x08,0x08,0x08,0x08,0x00,0x08,0x08,0x08,0x08,0x08,0x00,0x00,0x41,0x22,0x14,
+            0x08,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x3E,0x41,0x49,0x49,0x7A,0x00,0x7C,0x08,
+            0x04,0x04,0x08,0x00,0x20,0x54,0x54,0x54,0x78,0x00,0x7C,0x14,0x14,0x14,0x08,0x00,
+            0x7F,0x08,0x04,0x04,0x78,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+        },
+    },
+    {   // Exit
+        {
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0x49,0x49,0x49,0x41,0x00,0x44,0x28,
+            0x10,0x28,0x44,0x00,0x00,0x44,0x7D,0x40,0x00,0x00,0x04,0x3F,0x44,0x40,0x20,0x00,
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+        },
+        {
+            0x08,0x08,0x08,0x08,0x08,0x00,0x08,0x08,0x08,0x08,0x08,0x00,0x00,0x41,0x22,0x14,
+            0x08,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x7F,0x49,0x49,0x49,0x41,0x00,0x44,0x28,
+            0x10,0x28,0x44,0x00,0x00,0x44,0x7D,0x40,0x00,0x00,0x04,0x3F,0x44,0x40,0x20,0x00,
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+            0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+        },
+    },
+};
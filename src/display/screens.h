@@ -0,0 +1,28 @@
+#pragma once
+
+/* ------------------------------------------------------------
+   File generato da tools/screens/mkscreens: non modificare
+------------------------------------------------------------ */
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+
+/* ------------------------------------------------------------
+   Righe statiche pre-renderizzate con il font 5x7
+   Una pagina del display (8 pixel) per riga, un byte per
+   colonna; le colonne oltre la larghezza sono vuote.
+   Disegnare con OLED_blit_P(line, bitmap, larghezza)
+------------------------------------------------------------ */
+#define SCREENS_MENU_TITLE_W 99
+extern const uint8_t SCREENS_menu_title[SCREENS_MENU_TITLE_W] PROGMEM;   // "SELECT PARAMETER:"
+
+#define SCREENS_WELCOME_W 87
+extern const uint8_t SCREENS_welcome[SCREENS_WELCOME_W] PROGMEM;   // "       WELCOME!"
+
+#define SCREENS_GOODBYE_W 94
+extern const uint8_t SCREENS_goodbye[SCREENS_GOODBYE_W] PROGMEM;   // "     GOODBYE! :)"
+
+// Voci del menù: [voce][1 = selezionata]
+#define SCREENS_MENU_ITEMS 7
+#define SCREENS_MENU_W 89
+extern const uint8_t SCREENS_menu[SCREENS_MENU_ITEMS][2][SCREENS_MENU_W] PROGMEM;
@@ -0,0 +1,97 @@
+#include <string.h>
+
+#include "events.h"
+
+/* ------------------------------------------------------------
+   Configurazione di default: bande morte 0.10 °C, 0.10 hPa,
+   0.50 %RH, un report almeno ogni minuto, nessuna soglia
+------------------------------------------------------------ */
+static EVT_config_t cfg = {
+    { 10, 10, 50 }, { 0, 0, 0 }, { 0, 0, 0 }, { 0, 0, 0 },
+    EVT_DEFAULT_SILENCE_S, 0
+};
+
+static int32_t  base[EVT_CH_COUNT];   // ultimo valore riportato
+static uint32_t base_ms = 0;
+static uint8_t  base_valid = 0;
+
+static uint8_t  state[EVT_CH_COUNT];   // EVT_NORMAL all'avvio
+
+void EVT_get_config(EVT_config_t *c) {
+    *c = cfg;
+}
+
+/* ------------------------------------------------------------
+   EVT_set_config()
+   I canali disattivati tornano in stato normale
+------------------------------------------------------------ */
+uint8_t EVT_set_config(const EVT_config_t *c) {
+    for (uint8_t ch = 0; ch < EVT_CH_COUNT; ch++) {
+        if (!(c->alarm_mask & (1 << ch))) continue;
+        if (c->low[ch] >= c->high[ch] ||
+            (uint32_t)c->hyst[ch] >= (uint32_t)(c->high[ch] - c->low[ch])) return 1;
+    }
+    if (c->alarm_mask >> EVT_CH_COUNT) return 1;
+
+    cfg = *c;
+    for (uint8_t ch = 0; ch < EVT_CH_COUNT; ch++)
+        if (!(cfg.alarm_mask & (1 << ch))) state[ch] = EVT_NORMAL;
+    return 0;
+}
+
+/* ------------------------------------------------------------
+   EVT_report_due()
+------------------------------------------------------------ */
+uint8_t EVT_report_due(const int32_t *x, uint32_t ms) {
+    if (!base_valid) return 1;
+    if (cfg.max_silence_s && ms - base_ms >= (uint32_t)cfg.max_silence_s * 1000) return 1;
+
+    for (uint8_t ch = 0; ch < EVT_CH_COUNT; ch++) {
+        int32_t d = x[ch] - base[ch];
+        if (d < 0) d = -d;
+        if (!cfg.deadband[ch] || d > cfg.deadband[ch]) return 1;
+    }
+    return 0;
+}
+
+void EVT_report_done(const int32_t *x, uint32_t ms) {
+    memcpy(base, x, sizeof(base));
+    base_ms = ms;
+    base_valid = 1;
+}
+
+/* ------------------------------------------------------------
+   EVT_update_alarms()
+------------------------------------------------------------ */
+uint8_t EVT_update_alarms(const int32_t *x) {
+    uint8_t changed = 0;
+
+    for (uint8_t ch = 0; ch < EVT_CH_COUNT; ch++) {
+        if (!(cfg.alarm_mask & (1 << ch))) continue;
+
+        uint8_t s = state[ch];
+        if (s == EVT_HIGH && x[ch] < cfg.high[ch] - cfg.hyst[ch]) s = EVT_NORMAL;
+        if (s == EVT_LOW  && x[ch] > cfg.low[ch]  + cfg.hyst[ch]) s = EVT_NORMAL;
+        if (s == EVT_NORMAL) {
+            if (x[ch] >= cfg.high[ch])     s = EVT_HIGH;
+            else if (x[ch] <= cfg.low[ch]) s = EVT_LOW;
+        }
+
+        if (s != state[ch]) {
+            state[ch] = s;
+            changed |= 1 << ch;
+        }
+    }
+    return changed;
+}
+
+uint8_t EVT_alarm_state(uint8_t ch) {
+    return (ch < EVT_CH_COUNT) ? state[ch] : EVT_NORMAL;
+}
+
+uint8_t EVT_alarm_active(void) {
+    uint8_t m = 0;
+    for (uint8_t ch = 0; ch < EVT_CH_COUNT; ch++)
+        if (state[ch] != EVT_NORMAL) m |= 1 << ch;
+    return m;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <stdint.h>
+
+/* ------------------------------------------------------------
+   Report-by-exception e allarmi a soglia
+   - Banda morta: un campione va riportato solo se almeno un
+     canale si è spostato di più di deadband dall'ultimo valore
+     riportato, oppure se sono passati max_silence_s secondi
+     dall'ultimo report (0 = nessun report periodico).
+     deadband = 0 riporta ogni campione.
+   - Soglie con isteresi: un canale entra in allarme a x >= high
+     (o x <= low) e ne esce solo sotto high - hyst (o sopra
+     low + hyst), così il rumore vicino alla soglia non genera
+     una raffica di eventi.
+   Il modulo contiene solo lo stato: invio dei report e degli
+   eventi sono a carico del chiamante.
+------------------------------------------------------------ */
+typedef enum {
+    EVT_CH_TEMP  = 0,   // centesimi di °C  (stesso ordine di STATS_CH_*)
+    EVT_CH_PRESS = 1,   // Pa
+    EVT_CH_HUM   = 2,   // centesimi di %RH
+    EVT_CH_COUNT
+} EVT_channel_t;
+
+typedef enum {
+    EVT_NORMAL = 0,
+    EVT_LOW    = 1,
+    EVT_HIGH   = 2
+} EVT_state_t;
+
+/* ------------------------------------------------------------
+   Configurazione (unità dei canali)
+   Bit ch di alarm_mask a 1: soglie di ch attive
+------------------------------------------------------------ */
+typedef struct {
+    uint16_t deadband[EVT_CH_COUNT];
+    int32_t  low[EVT_CH_COUNT];
+    int32_t  high[EVT_CH_COUNT];
+    uint16_t hyst[EVT_CH_COUNT];
+    uint16_t max_silence_s;
+    uint8_t  alarm_mask;
+} EVT_config_t;
+
+#define EVT_DEFAULT_SILENCE_S 60
+
+/* ------------------------------------------------------------
+   API
+   - EVT_set_config(): 0 se valida (e applicata), 1 altrimenti
+     (low < high e hyst < high - low per i canali attivi)
+   - EVT_report_due(): 1 se il campione x[] va riportato
+   - EVT_report_done(): il campione è stato riportato e diventa
+     il nuovo riferimento della banda morta (un report scartato
+     per mancanza di banda viene così ritentato al campione dopo)
+   - EVT_update_alarms(): aggiorna gli stati, ritorna la maschera
+     dei canali il cui stato è cambiato
+   - EVT_alarm_state(): stato EVT_* di un canale
+   - EVT_alarm_active(): maschera dei canali in allarme
+------------------------------------------------------------ */
+void    EVT_get_config(EVT_config_t *c);
+uint8_t EVT_set_config(const EVT_config_t *c);
+
+uint8_t EVT_report_due(const int32_t *x, uint32_t ms);
+void    EVT_report_done(const int32_t *x, uint32_t ms);
+
+uint8_t EVT_update_alarms(const int32_t *x);
+uint8_t EVT_alarm_state(uint8_t ch);
+uint8_t EVT_alarm_active(void);
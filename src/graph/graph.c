@@ -0,0 +1,145 @@
+#include "../display/oled.h"
+#include "../history/history.h"
+#include "../stats/stats.h"
+#include "graph.h"
+
+/* ------------------------------------------------------------
+   Campioni del canale scelto, in int16 per risparmiare SRAM:
+   temperatura e umidità in centesimi, pressione in decine di Pa
+   (0.1 hPa). Il campione k (assoluto) sta in vals[k % GRAPH_COLS]
+   e viene disegnato nella stessa colonna; sono visibili gli
+   ultimi GRAPH_COLS - 1 (una colonna resta vuota come cursore)
+------------------------------------------------------------ */
+#define GRAPH_VISIBLE (GRAPH_COLS - 1)
+
+static int16_t  vals[GRAPH_COLS];
+static uint32_t total = 0;   // campioni ricevuti
+static uint32_t drawn = 0;   // campioni già nel framebuffer
+static uint8_t  full  = 1;   // ridisegno completo richiesto
+static uint8_t  channel = STATS_CH_TEMP;
+static int16_t  lo, hi;      // scala corrente (hi > lo)
+
+// Escursione minima della scala (0.2 °C, 0.5 hPa, 1 %RH):
+// sotto questa soglia il rumore del sensore riempirebbe l'altezza
+static const int16_t min_span[STATS_CH_COUNT] = { 20, 5, 100 };
+
+static int16_t GRAPH_value(uint8_t ch, int32_t v) {
+    return (ch == STATS_CH_PRESS) ? (int16_t)((v + 5) / 10) : (int16_t)v;
+}
+
+static uint32_t GRAPH_first(void) {
+    return (total > GRAPH_VISIBLE) ? total - GRAPH_VISIBLE : 0;
+}
+
+/* ------------------------------------------------------------
+   GRAPH_select()
+------------------------------------------------------------ */
+void GRAPH_select(uint8_t ch) {
+    if (ch >= STATS_CH_COUNT) return;
+    channel = ch;
+    total = drawn = 0;
+    full = 1;
+
+    uint32_t end = HIST_total(HIST_TIER_RAW);
+    uint8_t  n   = HIST_count(HIST_TIER_RAW);
+    if (n > GRAPH_VISIBLE) n = GRAPH_VISIBLE;
+    for (uint32_t k = end - n; k < end; k++) {
+        HIST_sample_t s;
+        if (HIST_get_raw(k, &s)) continue;
+        const int32_t x[STATS_CH_COUNT] = { s.temp, s.press, s.hum };
+        GRAPH_add(x);
+    }
+}
+
+uint8_t GRAPH_channel(void) {
+    return channel;
+}
+
+void GRAPH_add(const int32_t *x) {
+    vals[total % GRAPH_COLS] = GRAPH_value(channel, x[channel]);
+    total++;
+}
+
+void GRAPH_invalidate(void) {
+    full = 1;
+}
+
+/* ------------------------------------------------------------
+   GRAPH_scale()
+   Scala per i campioni visibili, con 1/8 di margine per lato
+------------------------------------------------------------ */
+static void GRAPH_scale(int16_t *out_lo, int16_t *out_hi) {
+    uint32_t first = GRAPH_first();
+    int16_t min = 0, max = 0;
+
+    for (uint32_t k = first; k < total; k++) {
+        int16_t v = vals[k % GRAPH_COLS];
+        if (k == first || v < min) min = v;
+        if (k == first || v > max) max = v;
+    }
+
+    int32_t span = (int32_t)max - min;
+    if (span < min_span[channel]) {
+        int32_t mid = ((int32_t)min + max) / 2;
+        span = min_span[channel];
+        min = (int16_t)(mid - span / 2);
+        max = (int16_t)(min + span);
+    }
+    *out_lo = (int16_t)(min - span / 8);
+    *out_hi = (int16_t)(max + span / 8);
+}
+
+// Riga del pixel (0 = in alto) di un valore nella scala corrente
+static uint8_t GRAPH_y(int16_t v) {
+    if (v >= hi) return 0;
+    if (v <= lo) return GRAPH_HEIGHT - 1;
+    return (uint8_t)(((int32_t)hi - v) * (GRAPH_HEIGHT - 1) / ((int32_t)hi - lo));
+}
+
+/* ------------------------------------------------------------
+   GRAPH_column()
+   Disegna la colonna del campione k: un segmento verticale dal
+   campione precedente, così la traccia resta continua
+------------------------------------------------------------ */
+static void GRAPH_column(uint32_t k) {
+    uint8_t bytes[GRAPH_PAGES] = { 0 };
+    uint8_t col = k % GRAPH_COLS;
+
+    if (k < total) {
+        uint8_t y1 = GRAPH_y(vals[col]);
+        uint8_t y0 = (k > GRAPH_first()) ? GRAPH_y(vals[(k - 1) % GRAPH_COLS]) : y1;
+        if (y0 > y1) { uint8_t t = y0; y0 = y1; y1 = t; }
+        for (uint8_t y = y0; y <= y1; y++) bytes[y >> 3] |= 1 << (y & 7);
+    }
+    OLED_put_column(col, GRAPH_PAGE_FIRST, bytes, GRAPH_PAGES);
+}
+
+/* ------------------------------------------------------------
+   GRAPH_draw()
+------------------------------------------------------------ */
+void GRAPH_draw(void) {
+    uint32_t first = GRAPH_first();
+    uint32_t from = (drawn > first) ? drawn : first;
+
+    if (!full) {
+        for (uint32_t k = from; k < total; k++) {
+            int16_t v = vals[k % GRAPH_COLS];
+            if (v < lo || v > hi) full = 1;   // fuori scala
+        }
+        if (!full && total / GRAPH_COLS != drawn / GRAPH_COLS) {
+            int16_t l, h;   // nuovo giro: la scala è troppo larga?
+            GRAPH_scale(&l, &h);
+            if (((int32_t)h - l) * 2 < (int32_t)hi - lo) full = 1;
+        }
+    }
+
+    if (full) {
+        GRAPH_scale(&lo, &hi);
+        for (uint8_t i = 0; i < GRAPH_COLS; i++) GRAPH_column(first + i);
+    } else {
+        for (uint32_t k = from; k < total; k++) GRAPH_column(k);
+        GRAPH_column(total);   // cursore: colonna vuota davanti all'ultimo campione
+    }
+    drawn = total;
+    full = 0;
+}
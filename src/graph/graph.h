@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stdint.h>
+
+/* ------------------------------------------------------------
+   Grafico dell'andamento di un canale (sparkline) sul display
+   Area del grafico: pagine GRAPH_PAGE_FIRST..7 (56 pixel) per
+   GRAPH_COLS colonne, un campione per colonna.
+   L'SH1106 non ha lo scorrimento orizzontale in hardware e far
+   scorrere il framebuffer cambierebbe (e farebbe reinviare) ogni
+   colonna: il grafico è quindi "a spazzola", come un
+   oscilloscopio. Ogni nuovo campione scrive la sua colonna sul
+   cursore, che avanza e lascia una colonna vuota davanti a sé:
+   per campione si inviano due colonne (14 byte).
+   Scala automatica: si ridisegna tutto solo quando un campione
+   esce dalla scala o, a ogni giro, se i dati ne occupano meno
+   della metà.
+------------------------------------------------------------ */
+#define GRAPH_COLS       128
+#define GRAPH_PAGE_FIRST 1
+#define GRAPH_PAGES      7
+#define GRAPH_HEIGHT     (GRAPH_PAGES * 8)
+
+/* ------------------------------------------------------------
+   API (canali STATS_CH_*, valori nelle unità dei canali)
+   - GRAPH_select(): cambia canale e ricarica gli ultimi campioni
+     dallo storico (HIST_TIER_RAW); il prossimo disegno è completo
+   - GRAPH_add(): un campione (tutti i canali); solo in SRAM
+   - GRAPH_invalidate(): il prossimo disegno è completo (da
+     chiamare quando il grafico torna sullo schermo)
+   - GRAPH_draw(): scrive nel framebuffer le colonne nuove
+------------------------------------------------------------ */
+void    GRAPH_select(uint8_t ch);
+uint8_t GRAPH_channel(void);
+void    GRAPH_add(const int32_t *x);
+void    GRAPH_invalidate(void);
+void    GRAPH_draw(void);
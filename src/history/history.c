@@ -0,0 +1,135 @@
+#include "history.h"
+
+/* ------------------------------------------------------------
+   Livello grezzo
+------------------------------------------------------------ */
+static HIST_sample_t raw[HIST_RAW_SIZE];
+static uint8_t  raw_head = 0;    // prossima posizione (evita % a 32 bit)
+static uint32_t raw_total = 0;
+
+/* ------------------------------------------------------------
+   Livelli aggregati: buffer circolare + intervallo in corso
+------------------------------------------------------------ */
+typedef struct {
+    uint32_t start_s;
+    uint32_t n;              // 15 min a ~100 Hz: ~90000 campioni
+    int32_t  t_sum;          // le somme stanno in 32 bit fino a ~390000 campioni
+    uint32_t p_sum, h_sum;
+    int16_t  t_min, t_max;
+    uint16_t p_min, p_max;
+    uint16_t h_min, h_max;
+} HIST_acc_t;
+
+typedef struct {
+    HIST_bucket_t *buf;
+    uint8_t        size;
+    uint16_t       period_s;
+    uint8_t        head;
+    uint32_t       total;
+    HIST_acc_t     acc;
+} HIST_level_t;
+
+static HIST_bucket_t buckets_1min[HIST_1MIN_SIZE];
+static HIST_bucket_t buckets_15min[HIST_15MIN_SIZE];
+
+static HIST_level_t levels[HIST_TIER_COUNT - 1] = {
+    { buckets_1min,  HIST_1MIN_SIZE,  60,  0, 0, { 0 } },
+    { buckets_15min, HIST_15MIN_SIZE, 900, 0, 0, { 0 } },
+};
+
+/* ------------------------------------------------------------
+   Chiude l'intervallo in corso e lo aggiunge al buffer
+------------------------------------------------------------ */
+static void HIST_close(HIST_level_t *l) {
+    HIST_acc_t *a = &l->acc;
+    HIST_bucket_t *b = &l->buf[l->head];
+
+    b->start_s = a->start_s;
+    b->n       = (a->n > 0xFFFF) ? 0xFFFF : (uint16_t)a->n;   // saturato
+    b->t_min = a->t_min; b->t_max = a->t_max;
+    b->p_min = a->p_min; b->p_max = a->p_max;
+    b->h_min = a->h_min; b->h_max = a->h_max;
+    // medie arrotondate (t_sum può essere negativa)
+    b->t_avg = (int16_t)((a->t_sum + (a->t_sum < 0 ? -(int32_t)a->n : (int32_t)a->n) / 2) / (int32_t)a->n);
+    b->p_avg = (uint16_t)((a->p_sum + a->n / 2) / a->n);
+    b->h_avg = (uint16_t)((a->h_sum + a->n / 2) / a->n);
+    if (++l->head == l->size) l->head = 0;
+    l->total++;
+    a->n = 0;
+}
+
+/* ------------------------------------------------------------
+   Aggiunge un campione all'intervallo del livello; se il
+   campione appartiene a un intervallo successivo chiude prima
+   quello in corso (gli intervalli senza campioni sono omessi)
+------------------------------------------------------------ */
+static void HIST_accumulate(HIST_level_t *l, uint32_t now_s,
+                            int16_t t, uint16_t p, uint16_t h) {
+    HIST_acc_t *a = &l->acc;
+    uint32_t start = now_s - now_s % l->period_s;
+
+    if (a->n && start != a->start_s) HIST_close(l);
+
+    if (a->n == 0) {
+        a->start_s = start;
+        a->t_sum = 0; a->p_sum = 0; a->h_sum = 0;
+        a->t_min = a->t_max = t;
+        a->p_min = a->p_max = p;
+        a->h_min = a->h_max = h;
+    }
+    a->n++;
+    a->t_sum += t; a->p_sum += p; a->h_sum += h;
+    if (t < a->t_min) a->t_min = t;
+    if (t > a->t_max) a->t_max = t;
+    if (p < a->p_min) a->p_min = p;
+    if (p > a->p_max) a->p_max = p;
+    if (h < a->h_min) a->h_min = h;
+    if (h > a->h_max) a->h_max = h;
+}
+
+/* ------------------------------------------------------------
+   HIST_add()
+------------------------------------------------------------ */
+void HIST_add(const HIST_sample_t *s) {
+    raw[raw_head] = *s;
+    if (++raw_head == HIST_RAW_SIZE) raw_head = 0;
+    raw_total++;
+
+    uint32_t now_s = s->ms / 1000;
+    uint16_t p = (uint16_t)((s->press + 5) / 10);
+    for (uint8_t i = 0; i < HIST_TIER_COUNT - 1; i++)
+        HIST_accumulate(&levels[i], now_s, s->temp, p, s->hum);
+}
+
+/* ------------------------------------------------------------
+   HIST_total() / HIST_count()
+------------------------------------------------------------ */
+uint32_t HIST_total(uint8_t tier) {
+    if (tier == HIST_TIER_RAW) return raw_total;
+    if (tier < HIST_TIER_COUNT) return levels[tier - 1].total;
+    return 0;
+}
+
+uint8_t HIST_count(uint8_t tier) {
+    uint32_t total = HIST_total(tier);
+    uint8_t size = (tier == HIST_TIER_RAW) ? HIST_RAW_SIZE :
+                   (tier < HIST_TIER_COUNT) ? levels[tier - 1].size : 0;
+    return (total < size) ? (uint8_t)total : size;
+}
+
+/* ------------------------------------------------------------
+   HIST_get_raw() / HIST_get_bucket()
+------------------------------------------------------------ */
+uint8_t HIST_get_raw(uint32_t k, HIST_sample_t *out) {
+    if (k >= raw_total || raw_total - k > HIST_RAW_SIZE) return 1;
+    *out = raw[k % HIST_RAW_SIZE];
+    return 0;
+}
+
+uint8_t HIST_get_bucket(uint8_t tier, uint32_t k, HIST_bucket_t *out) {
+    if (tier == HIST_TIER_RAW || tier >= HIST_TIER_COUNT) return 1;
+    HIST_level_t *l = &levels[tier - 1];
+    if (k >= l->total || l->total - k > l->size) return 1;
+    *out = l->buf[k % l->size];
+    return 0;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <stdint.h>
+
+/* ------------------------------------------------------------
+   Storico dei campioni in SRAM, su più livelli:
+   - HIST_TIER_RAW:   ultimi campioni alla frequenza di campionamento
+   - HIST_TIER_1MIN:  min/media/max per minuto
+   - HIST_TIER_15MIN: min/media/max per quarto d'ora
+   Ogni livello è un buffer circolare: i dati più vecchi vengono
+   sovrascritti. Le dimensioni sono ridefinibili in compilazione;
+   con quelle di default occupa circa 3.0 KB di SRAM
+   (448 + 1440 + 1152 byte più gli accumulatori).
+------------------------------------------------------------ */
+#ifndef HIST_RAW_SIZE
+#define HIST_RAW_SIZE   32   // 14 byte ciascuno
+#endif
+#ifndef HIST_1MIN_SIZE
+#define HIST_1MIN_SIZE  60   // 1 ora, 24 byte ciascuno
+#endif
+#ifndef HIST_15MIN_SIZE
+#define HIST_15MIN_SIZE 48   // 12 ore, 24 byte ciascuno
+#endif
+
+typedef enum {
+    HIST_TIER_RAW   = 0,
+    HIST_TIER_1MIN  = 1,
+    HIST_TIER_15MIN = 2,
+    HIST_TIER_COUNT
+} HIST_tier_t;
+
+/* ------------------------------------------------------------
+   Campione (stesse unità della telemetria binaria)
+------------------------------------------------------------ */
+typedef struct {
+    uint32_t ms;          // istante della lettura (TIMER_millis())
+    uint16_t seq;         // BME280_sequence()
+    int16_t  temp;        // centesimi di °C
+    uint32_t press;       // Pa
+    uint16_t hum;         // centesimi di %RH
+} HIST_sample_t;
+
+/* ------------------------------------------------------------
+   Intervallo aggregato
+   La pressione è in decimi di hPa (10 Pa) per stare in 16 bit
+------------------------------------------------------------ */
+typedef struct {
+    uint32_t start_s;                  // inizio dell'intervallo (s dall'avvio)
+    uint16_t n;                        // campioni aggregati (max 65535)
+    int16_t  t_min, t_avg, t_max;      // centesimi di °C
+    uint16_t p_min, p_avg, p_max;      // decimi di hPa
+    uint16_t h_min, h_avg, h_max;      // centesimi di %RH
+} HIST_bucket_t;
+
+/* ------------------------------------------------------------
+   API
+   - HIST_add(): registra un campione e chiude gli intervalli
+     aggregati terminati
+   - HIST_count(): elementi presenti nel livello
+   - HIST_total(): elementi registrati dall'avvio nel livello;
+     l'elemento assoluto k è disponibile se
+     HIST_total() - HIST_count() <= k < HIST_total()
+   - HIST_get_raw() / HIST_get_bucket(): leggono l'elemento
+     assoluto k; ritornano 1 se non più (o non ancora) presente
+------------------------------------------------------------ */
+void     HIST_add(const HIST_sample_t *s);
+uint8_t  HIST_count(uint8_t tier);
+uint32_t HIST_total(uint8_t tier);
+uint8_t  HIST_get_raw(uint32_t k, HIST_sample_t *out);
+uint8_t  HIST_get_bucket(uint8_t tier, uint32_t k, HIST_bucket_t *out);
@@ -2,26 +2,66 @@
 #include <stdio.h>
 #include <string.h>
 #include <avr/interrupt.h>
+#include <avr/pgmspace.h>
 #include <util/delay.h>
 
 #include "../../avr_common/uart/uart.h"
 #include "../../avr_common/i2c/i2c.h"
+#include "../../avr_common/timer/timer.h"
+#include "../scheduler/scheduler.h"
 #include "../sensors/bme280.h"
 #include "../display/oled.h"
+#include "../display/screens.h"
 #include "../buttons/buttons.h"
+#include "../storage/storage.h"
+#include "../history/history.h"
+#include "../stats/stats.h"
+#include "../events/events.h"
+#include "../graph/graph.h"
+#include "../telemetry/telemetry.h"
 #include "proxy.h"
 
+/* ------------------------------------------------------------
+   Periodi dei task dello scheduler (ms)
+------------------------------------------------------------ */
+#define PROXY_SAMPLE_POLL_MS 2   // controllo di nuove conversioni BME280
+#define PROXY_BUTTONS_MS 10
+#define PROXY_DISPLAY_MS 50
+#define PROXY_UART_MS    10   // controllo dei comandi ricevuti
+#define PROXY_POWER_REPORT_MS 10000   // report duty cycle in low-power
+#define PROXY_BAUD_CONFIRM_MS 1000    // attesa del "ping" dopo un cambio di baud
+
 /* ------------------------------------------------------------
    Configurazione globale
 ------------------------------------------------------------ */
-static uint16_t sampling_ms = 1000;
+static uint16_t sampling_ms = 1000;   // "set rate"; 0 = standby del profilo
+static uint8_t  sensor_profile = BME280_PROFILE_WEATHER;
 static uint8_t  log_enabled = 1;
+static log_format_t log_format = LOG_TEXT;
+static uint8_t  low_power   = 0;   // forced mode + sleep tra i campioni
 static temp_unit_t  temp_unit  = UNIT_C;
 static press_unit_t press_unit = UNIT_PA;
 
-static float last_temp  = 0.0f;
-static float last_press = 0.0f;
-static float last_hum   = 0.0f;
+static uint16_t last_seq = 0;     // BME280_sequence() dell'ultimo campione
+
+#if PROXY_FIXED_POINT
+static int16_t  last_temp  = 0;   // centesimi di °C
+static uint32_t last_press = 0;   // Pa
+static uint32_t last_hum   = 0;   // %RH Q22.10
+
+// Conversione verso le unità intere usate dalla formattazione
+#define TEMP_CENTI(x) ((int32_t)(x))                       // centesimi di °C
+#define PRESS_PA(x)   ((int32_t)(x))                       // Pa
+#define HUM_CENTI(x)  ((int32_t)(((x) * 100 + 512) >> 10)) // centesimi di %RH
+#else
+static float last_temp  = 0.0f;   // °C
+static float last_press = 0.0f;   // hPa
+static float last_hum   = 0.0f;   // %RH
+
+#define TEMP_CENTI(x) ((int32_t)((x) * 100.0f + ((x) < 0 ? -0.5f : 0.5f)))
+#define PRESS_PA(x)   ((int32_t)((x) * 100.0f + 0.5f))
+#define HUM_CENTI(x)  ((int32_t)((x) * 100.0f + 0.5f))
+#endif
 
 /* ------------------------------------------------------------
    Converte una stringa in minuscolo
@@ -33,53 +73,317 @@ static void str_to_lower(char *s) {
     }
 }
 
+/* ------------------------------------------------------------
+   Formattazione intera (senza dtostrf/printf)
+   fmt_fixed() scrive value / 10^dec con dec decimali,
+   allineato a destra su width caratteri.
+   Entrambe scrivono al massimo fino a end e ritornano il
+   puntatore al primo carattere libero.
+------------------------------------------------------------ */
+static char *fmt_fixed(char *p, char *end, int32_t value, uint8_t dec, uint8_t width) {
+    char tmp[12];
+    uint8_t i = 0;
+    uint8_t min = dec ? dec + 2 : 1;   // almeno "0.xx"
+    uint32_t v = (value < 0) ? -(uint32_t)value : (uint32_t)value;
+
+    do {
+        tmp[i++] = '0' + (v % 10);
+        v /= 10;
+        if (i == dec) tmp[i++] = '.';
+    } while (v || i < min);
+    if (value < 0) tmp[i++] = '-';
+
+    while (width > i && p < end) { *p++ = ' '; width--; }
+    while (i && p < end) *p++ = tmp[--i];
+    return p;
+}
+
+static char *append_P(char *p, char *end, const char *s) {
+    char c;
+    while (p < end && (c = (char)pgm_read_byte(s++))) *p++ = c;
+    return p;
+}
+
+/* ------------------------------------------------------------
+   Conversioni di unità in virgola fissa (centesimi)
+   fmt_temp() / fmt_press() scrivono il valore nell'unità scelta;
+   con delta = 1 il valore è una differenza (es. deviazione
+   standard) e l'offset di K e °F non si applica
+------------------------------------------------------------ */
+static char *fmt_temp(char *p, char *end, int32_t centi, uint8_t delta, uint8_t width) {
+    if (temp_unit == UNIT_K) {
+        if (!delta) centi += 27315;
+    } else if (temp_unit == UNIT_F) {
+        centi = (centi * 9 + (centi < 0 ? -2 : 2)) / 5 + (delta ? 0 : 3200);
+    }
+    return fmt_fixed(p, end, centi, 2, width);
+}
+
+static char *fmt_press(char *p, char *end, int32_t pa, uint8_t width) {
+    if (press_unit == UNIT_BAR)
+        return fmt_fixed(p, end, (pa + 50) / 100, 3, width);   // millibar → x.xxx bar
+    return fmt_fixed(p, end, pa, 2, width);                    // Pa → xxxx.xx hPa
+}
+
+static const char *temp_unit_P(void) {
+    return temp_unit == UNIT_K ? PSTR(" K") : temp_unit == UNIT_F ? PSTR(" F") : PSTR(" C");
+}
+
+static const char *press_unit_P(void) {
+    return press_unit == UNIT_BAR ? PSTR(" bar") : PSTR(" hPa");
+}
+
 /* ------------------------------------------------------------
    Formatta i valori letti dai sensori
 ------------------------------------------------------------ */
 static void format_temp(char *out, size_t n) {
-    float t = last_temp;
-    const char *unit = "C";
-    if (temp_unit == UNIT_K) { t += 273.15f; unit = "K"; }
-    else if (temp_unit == UNIT_F) { t = t * 9.0f / 5.0f + 32.0f; unit = "F"; }
-
-    char buf[16];
-    dtostrf(t, 6, 2, buf);
-    snprintf(out, n, "Temperature: %s %s", buf, unit);
+    char *p = out, *end = out + n - 1;
+    p = append_P(p, end, PSTR("Temperature: "));
+    p = fmt_temp(p, end, TEMP_CENTI(last_temp), 0, 6);
+    p = append_P(p, end, temp_unit_P());
+    *p = '\0';
 }
 
 static void format_press(char *out, size_t n) {
-    float p = last_press;
-    if (press_unit == UNIT_BAR) {
-        p /= 1000.0f;
-        char buf[16];
-        dtostrf(p, 7, 3, buf);
-        snprintf(out, n, "Pressure: %s bar", buf);
-    } else {
-        char buf[16];
-        dtostrf(p, 7, 2, buf);
-        snprintf(out, n, "Pressure: %s hPa", buf);
-    }
+    char *p = out, *end = out + n - 1;
+    p = append_P(p, end, PSTR("Pressure: "));
+    p = fmt_press(p, end, PRESS_PA(last_press), 7);
+    p = append_P(p, end, press_unit_P());
+    *p = '\0';
 }
 
 static void format_hum(char *out, size_t n) {
-    char buf[16];
-    dtostrf(last_hum, 6, 2, buf);
-    snprintf(out, n, "Humidity: %s %%", buf);
+    char *p = out, *end = out + n - 1;
+    p = append_P(p, end, PSTR("Humidity: "));
+    p = fmt_fixed(p, end, HUM_CENTI(last_hum), 2, 6);
+    p = append_P(p, end, PSTR(" %"));
+    *p = '\0';
+}
+
+/* ------------------------------------------------------------
+   fmt_stat_value()
+   Un valore di un canale STATS_CH_* nell'unità scelta
+------------------------------------------------------------ */
+static char *fmt_stat_value(char *p, char *end, uint8_t ch, int32_t v, uint8_t delta, uint8_t width) {
+    if (ch == STATS_CH_TEMP)  return fmt_temp(p, end, v, delta, width);
+    if (ch == STATS_CH_PRESS) return fmt_press(p, end, v, width);
+    return fmt_fixed(p, end, v, 2, width);
+}
+
+static const char *stat_unit_P(uint8_t ch) {
+    if (ch == STATS_CH_TEMP)  return temp_unit_P();
+    if (ch == STATS_CH_PRESS) return press_unit_P();
+    return PSTR(" %");
 }
 
 /* ------------------------------------------------------------
    Mostra un’introduzione del progetto sul terminale
 ------------------------------------------------------------ */
 static void PROXY_intro(void) {
-    UART_putString("\r\n\r\n=============================== PROJECT OVERVIEW ===============================\r\n");
-    UART_putString("This project implements an Arduino-based Environmental Monitor featuring:\r\n");
-    UART_putString("- A BME280 sensor for temperature, pressure, and humidity measurements\r\n");
-    UART_putString("- An OLED display for real-time data visualization\r\n");
-    UART_putString("- Two buttons for user interaction:\r\n");
-    UART_putString("    * LEFT  button: scroll through menu\r\n");
-    UART_putString("    * RIGHT button: confirm selection\r\n");
-    UART_putString("\r\nTo exit, select \"Exit\" from the display menu.\r\n");
-    UART_putString("================================================================================\r\n\r\n");
+    UART_putString_P(PSTR("\r\n\r\n=============================== PROJECT OVERVIEW ===============================\r\n"));
+    UART_putString_P(PSTR("This project implements an Arduino-based Environmental Monitor featuring:\r\n"));
+    UART_putString_P(PSTR("- A BME280 sensor for temperature, pressure, and humidity measurements\r\n"));
+    UART_putString_P(PSTR("- An OLED display for real-time data visualization\r\n"));
+    UART_putString_P(PSTR("- Two buttons for user interaction:\r\n"));
+    UART_putString_P(PSTR("    * LEFT  button: scroll through menu\r\n"));
+    UART_putString_P(PSTR("    * RIGHT button: confirm selection\r\n"));
+    UART_putString_P(PSTR("\r\nTo exit, select \"Exit\" from the display menu.\r\n"));
+    UART_putString_P(PSTR("================================================================================\r\n\r\n"));
+}
+
+/* ------------------------------------------------------------
+   PROXY_report_sensor()
+   Riporta profilo, oversampling, filtro IIR, durata massima
+   della conversione e frequenza di uscita del sensore
+------------------------------------------------------------ */
+static const char profile_names[BME280_PROFILE_COUNT][16] PROGMEM = {
+    "low-latency", "balanced", "low-noise", "weather-station"
+};
+
+static void PROXY_report_sensor(void) {
+    BME280_config_t c;
+    BME280_get_config(&c);
+    uint32_t odr = BME280_output_rate_mhz();
+    char name[16];
+    strcpy_P(name, profile_names[sensor_profile]);
+
+    char msg[128];
+    snprintf_P(msg, sizeof(msg),
+             PSTR("Sensor: %s | osrs T/P/H: %u/%u/%u | IIR: %u | t_meas: %lu us | ODR: %lu.%02lu Hz\r\n"),
+             name,
+             c.osrs_t ? 1 << (c.osrs_t - 1) : 0,
+             c.osrs_p ? 1 << (c.osrs_p - 1) : 0,
+             c.osrs_h ? 1 << (c.osrs_h - 1) : 0,
+             c.filter ? 1 << c.filter : 0,
+             (unsigned long)BME280_measure_time_us(),
+             (unsigned long)(odr / 1000), (unsigned long)(odr % 1000 / 10));
+    UART_putString(msg);
+}
+
+/* ------------------------------------------------------------
+   PROXY_report_events()
+   Riporta bande morte e soglie, sempre in °C, hPa e %RH
+   (le unità dei comandi "set deadband" e "set alarm")
+------------------------------------------------------------ */
+static const char evt_labels[EVT_CH_COUNT] PROGMEM = { 'T', 'P', 'H' };
+static const char evt_units[EVT_CH_COUNT][5] PROGMEM = { " C", " hPa", " %" };
+static const char evt_states[3][8] PROGMEM = { "cleared", "LOW", "HIGH" };
+
+static void PROXY_report_events(void) {
+    EVT_config_t c;
+    EVT_get_config(&c);
+    char msg[96];
+    char *end = msg + sizeof(msg) - 1;
+    char *p = append_P(msg, end, PSTR("Report-by-exception: deadband"));
+
+    for (uint8_t ch = 0; ch < EVT_CH_COUNT; ch++) {
+        p = append_P(p, end, ch ? PSTR(" | ") : PSTR(" "));
+        *p++ = pgm_read_byte(&evt_labels[ch]);
+        *p++ = ' ';
+        p = fmt_fixed(p, end, c.deadband[ch], 2, 0);
+        p = append_P(p, end, evt_units[ch]);
+    }
+    p += snprintf_P(p, end - p, PSTR(" | silence %u s\r\n"), c.max_silence_s);
+    *p = '\0';
+    UART_putString(msg);
+
+    for (uint8_t ch = 0; ch < EVT_CH_COUNT; ch++) {
+        if (!(c.alarm_mask & (1 << ch))) continue;
+        p = append_P(msg, end, PSTR("Alarm "));
+        *p++ = pgm_read_byte(&evt_labels[ch]);
+        p = append_P(p, end, PSTR(": low "));
+        p = fmt_fixed(p, end, c.low[ch], 2, 0);
+        p = append_P(p, end, PSTR(" | high "));
+        p = fmt_fixed(p, end, c.high[ch], 2, 0);
+        p = append_P(p, end, PSTR(" | hyst "));
+        p = fmt_fixed(p, end, c.hyst[ch], 2, 0);
+        p = append_P(p, end, evt_units[ch]);
+        p = append_P(p, end, PSTR(" | state "));
+        p = append_P(p, end, evt_states[EVT_alarm_state(ch)]);
+        p = append_P(p, end, PSTR("\r\n"));
+        *p = '\0';
+        UART_putString(msg);
+    }
+}
+
+/* ------------------------------------------------------------
+   PROXY_period_ms()
+   Periodo di campionamento: quello di "set rate" oppure, se la
+   frequenza è quella del profilo, t_meas + t_standby del profilo
+------------------------------------------------------------ */
+static uint16_t PROXY_period_ms(void) {
+    if (sampling_ms) return sampling_ms;
+    return (uint16_t)((1000000UL + BME280_output_rate_mhz() - 1) / BME280_output_rate_mhz());
+}
+
+/* ------------------------------------------------------------
+   PROXY_report_config()
+   Riporta la configurazione corrente del proxy e del sensore
+------------------------------------------------------------ */
+static void PROXY_report_config(void) {
+    char conf[128];
+    snprintf_P(conf, sizeof(conf),
+             PSTR("Sampling: %u ms (%s) | Temp: %s | Press: %s | Log: %s (%s) | Low-power: %s\r\n"),
+             PROXY_period_ms(),
+             (sampling_ms ? "set rate" : "profile"),
+             (temp_unit == UNIT_C ? "C" : temp_unit == UNIT_K ? "K" : "F"),
+             (press_unit == UNIT_BAR ? "bar" : "hPa"),
+             (log_enabled ? "ON" : "OFF"),
+             (log_format == LOG_BINARY ? "binary" : "text"),
+             (low_power ? "ON" : "OFF"));
+    UART_putString(conf);
+    PROXY_report_sensor();
+    PROXY_report_events();
+}
+
+/* ------------------------------------------------------------
+   PROXY_set_low_power()
+   on = 1: BME280 in modalità forced (una conversione ogni
+           PROXY_period_ms()) e CPU in idle tra un evento e l'altro
+   on = 0: BME280 in modalità normale, nessuno sleep
+------------------------------------------------------------ */
+static void PROXY_set_low_power(uint8_t on) {
+    low_power = on;
+    BME280_set_mode(on ? BME280_MODE_FORCED : BME280_MODE_NORMAL);
+}
+
+/* ------------------------------------------------------------
+   Configurazione persistente (record STORAGE_ID_CONFIG)
+------------------------------------------------------------ */
+typedef struct {
+    uint16_t sampling_ms;
+    uint8_t  sensor_profile;
+    uint8_t  temp_unit;
+    uint8_t  press_unit;
+    uint8_t  log_enabled;
+    uint8_t  log_format;
+    uint8_t  low_power;
+} PROXY_saved_config_t;
+
+static void PROXY_save_config(void) {
+    PROXY_saved_config_t c = {
+        sampling_ms, sensor_profile, temp_unit, press_unit, log_enabled, log_format, low_power
+    };
+    STORAGE_save(STORAGE_ADDR_CONFIG, STORAGE_ID_CONFIG, &c, sizeof(c));
+
+    EVT_config_t e;
+    EVT_get_config(&e);
+    STORAGE_save(STORAGE_ADDR_EVENTS, STORAGE_ID_EVENTS, &e, sizeof(e));
+}
+
+/* ------------------------------------------------------------
+   PROXY_load_config()
+   Ripristina e applica la configurazione salvata;
+   ritorna 1 se assente o non valida (nulla viene modificato)
+------------------------------------------------------------ */
+static uint8_t PROXY_load_config(void) {
+    PROXY_saved_config_t c;
+    if (STORAGE_load(STORAGE_ADDR_CONFIG, STORAGE_ID_CONFIG, &c, sizeof(c))) return 1;
+
+    if ((c.sampling_ms != 0   && c.sampling_ms != 125 && c.sampling_ms != 250 &&
+         c.sampling_ms != 500 && c.sampling_ms != 1000) ||
+        c.sensor_profile >= BME280_PROFILE_COUNT ||
+        c.temp_unit > UNIT_F || c.press_unit > UNIT_BAR ||
+        c.log_format > LOG_BINARY) return 1;
+
+    sampling_ms    = c.sampling_ms;
+    sensor_profile = c.sensor_profile;
+    temp_unit      = c.temp_unit;
+    press_unit     = c.press_unit;
+    log_enabled    = c.log_enabled ? 1 : 0;
+    log_format     = c.log_format;
+
+    BME280_apply_profile(sensor_profile);
+    if (sampling_ms) BME280_set_sampling(sampling_ms);
+    PROXY_set_low_power(c.low_power ? 1 : 0);
+    return 0;
+}
+
+/* ------------------------------------------------------------
+   PROXY_load_events()
+   Bande morte e soglie salvate (record separato: se manca o non
+   è valido restano i valori di default di src/events)
+------------------------------------------------------------ */
+static void PROXY_load_events(void) {
+    EVT_config_t e;
+    if (!STORAGE_load(STORAGE_ADDR_EVENTS, STORAGE_ID_EVENTS, &e, sizeof(e)))
+        EVT_set_config(&e);
+}
+
+/* ------------------------------------------------------------
+   PROXY_sensor_init()
+   Inizializza il BME280 con la calibrazione salvata in EEPROM;
+   se manca o non corrisponde al sensore la rilegge e la salva
+------------------------------------------------------------ */
+static void PROXY_sensor_init(void) {
+    uint8_t calib[BME280_CALIB_LEN];
+
+    if (!STORAGE_load(STORAGE_ADDR_CALIB, STORAGE_ID_CALIB, calib, sizeof(calib)) &&
+        !BME280_init_cached(calib)) return;
+
+    BME280_init();
+    if (!BME280_get_calibration(calib))
+        STORAGE_save(STORAGE_ADDR_CALIB, STORAGE_ID_CALIB, calib, sizeof(calib));
 }
 
 /* ------------------------------------------------------------
@@ -88,9 +392,23 @@ static void PROXY_intro(void) {
 ------------------------------------------------------------ */
 static void PROXY_configure(void) {
     char buf[32];
-    UART_putString("\r\n\r\n================================ CONFIGURATION =================================\r\n");
-    UART_putString("Select sampling rate (1-4):\r\n");
-    UART_putString("1) 125 ms\r\n2) 250 ms\r\n3) 500 ms\r\n4) 1000 ms\r\n> ");
+    UART_putString_P(PSTR("\r\n\r\n================================ CONFIGURATION =================================\r\n"));
+    UART_putString_P(PSTR("Select sensor profile (1-4):\r\n"));
+    UART_putString_P(PSTR("1) low-latency\r\n2) balanced\r\n3) low-noise\r\n4) weather-station\r\n> "));
+
+    while (1) {
+        UART_getString(buf, sizeof(buf));
+        int opt = atoi(buf);
+        if (opt >= 1 && opt <= BME280_PROFILE_COUNT) {
+            sensor_profile = opt - 1;
+            BME280_apply_profile(sensor_profile);
+            break;
+        }
+        UART_putString_P(PSTR("Invalid value. Enter a number from 1 to 4: "));
+    }
+
+    UART_putString_P(PSTR("Select sampling rate (1-5):\r\n"));
+    UART_putString_P(PSTR("1) 125 ms\r\n2) 250 ms\r\n3) 500 ms\r\n4) 1000 ms\r\n5) sensor profile\r\n> "));
 
     while (1) {
         UART_getString(buf, sizeof(buf));
@@ -101,55 +419,117 @@ static void PROXY_configure(void) {
                 case 2: sampling_ms = 250; break;
                 case 3: sampling_ms = 500; break;
                 case 4: sampling_ms = 1000; break;
+                case 5: sampling_ms = 0; break;   // standby del profilo scelto
             }
-            BME280_set_sampling(sampling_ms);
+            if (sampling_ms) BME280_set_sampling(sampling_ms);
             break;
         }
-        UART_putString("Invalid value. Enter a number from 1 to 5: ");
+        UART_putString_P(PSTR("Invalid value. Enter a number from 1 to 5: "));
     }
 
-    UART_putString("Temperature unit (C/K/F): ");
+    UART_putString_P(PSTR("Temperature unit (C/K/F): "));
     while (1) {
         UART_getString(buf, sizeof(buf));
         str_to_lower(buf);
-        if (!strcmp(buf, "c")) { temp_unit = UNIT_C; break; }
-        if (!strcmp(buf, "k")) { temp_unit = UNIT_K; break; }
-        if (!strcmp(buf, "f")) { temp_unit = UNIT_F; break; }
-        UART_putString("Invalid value (C/K/F): ");
+        if (!strcmp_P(buf, PSTR("c"))) { temp_unit = UNIT_C; break; }
+        if (!strcmp_P(buf, PSTR("k"))) { temp_unit = UNIT_K; break; }
+        if (!strcmp_P(buf, PSTR("f"))) { temp_unit = UNIT_F; break; }
+        UART_putString_P(PSTR("Invalid value (C/K/F): "));
     }
 
-    UART_putString("Pressure unit (Pa/bar): ");
+    UART_putString_P(PSTR("Pressure unit (Pa/bar): "));
     while (1) {
         UART_getString(buf, sizeof(buf));
         str_to_lower(buf);
-        if (!strcmp(buf, "pa"))  { press_unit = UNIT_PA;  break; }
-        if (!strcmp(buf, "bar")) { press_unit = UNIT_BAR; break; }
-        UART_putString("Invalid value (Pa/bar): ");
+        if (!strcmp_P(buf, PSTR("pa")))  { press_unit = UNIT_PA;  break; }
+        if (!strcmp_P(buf, PSTR("bar"))) { press_unit = UNIT_BAR; break; }
+        UART_putString_P(PSTR("Invalid value (Pa/bar): "));
     }
 
-    UART_putString("Enable terminal log? (on/off): ");
+    UART_putString_P(PSTR("Enable terminal log? (on/off): "));
     while (1) {
         UART_getString(buf, sizeof(buf));
         str_to_lower(buf);
-        if (!strcmp(buf, "on"))  { log_enabled = 1; break; }
-        if (!strcmp(buf, "off")) { log_enabled = 0; break; }
-        UART_putString("Invalid value (on/off): ");
+        if (!strcmp_P(buf, PSTR("on")))  { log_enabled = 1; break; }
+        if (!strcmp_P(buf, PSTR("off"))) { log_enabled = 0; break; }
+        UART_putString_P(PSTR("Invalid value (on/off): "));
     }
 
-    UART_putString("================================================================================\r\n");
-    char conf[128];
-    snprintf(conf, sizeof(conf),
-             "Sampling: %u ms | Temp: %s | Press: %s | Log: %s\r\n",
-             sampling_ms,
-             (temp_unit == UNIT_C ? "C" : temp_unit == UNIT_K ? "K" : "F"),
-             (press_unit == UNIT_BAR ? "bar" : "hPa"),
-             (log_enabled ? "ON" : "OFF"));
-    UART_putString(conf);
-    UART_putString("Configuration complete!\r\n");
+    UART_putString_P(PSTR("Low-power mode? (on/off): "));
+    while (1) {
+        UART_getString(buf, sizeof(buf));
+        str_to_lower(buf);
+        if (!strcmp_P(buf, PSTR("on")))  { PROXY_set_low_power(1); break; }
+        if (!strcmp_P(buf, PSTR("off"))) { PROXY_set_low_power(0); break; }
+        UART_putString_P(PSTR("Invalid value (on/off): "));
+    }
+
+    UART_putString_P(PSTR("================================================================================\r\n"));
+    PROXY_report_config();
+    PROXY_save_config();
+    UART_putString_P(PSTR("Configuration complete and saved!\r\n"));
 
     PROXY_intro();
 }
 
+/* ------------------------------------------------------------
+   PROXY_measure_i2c()
+   Misura il tempo medio di una lettura burst del BME280
+   alla velocità di bus corrente (Timer1, prescaler 8 → 0.5 us)
+------------------------------------------------------------ */
+static void PROXY_measure_i2c(void) {
+    BME280_raw_t raw;
+    const uint8_t runs = 8;
+
+    TCCR1A = 0;
+    TCNT1  = 0;
+    TCCR1B = (1 << CS11);                 // avvia Timer1, F_CPU/8
+    for (uint8_t i = 0; i < runs; i++) BME280_read_raw(&raw);
+    uint16_t ticks = TCNT1;
+    TCCR1B = 0;                           // ferma Timer1
+
+    char msg[64];
+    snprintf_P(msg, sizeof(msg), PSTR("I2C: %lu Hz, BME280 burst read: %u us\r\n"),
+             (unsigned long)I2C_get_speed(), (unsigned)(ticks / 2 / runs));
+    UART_putString(msg);
+}
+
+/* ------------------------------------------------------------
+   PROXY_measure_compensation()
+   Confronta i cicli CPU della compensazione float (int64 +
+   soft-float) e di quella in virgola fissa sullo stesso
+   snapshot grezzo (Timer1 senza prescaler → 1 tick = 1 ciclo)
+------------------------------------------------------------ */
+static void PROXY_measure_compensation(void) {
+    BME280_raw_t raw;
+    BME280_data_t f;
+    BME280_fixed_t x;
+    const uint8_t runs = 4;
+    uint32_t cyc_float = 0, cyc_fixed = 0;
+
+    if (BME280_read_raw(&raw)) return;
+
+    TCCR1A = 0;
+    for (uint8_t i = 0; i < runs; i++) {
+        TCNT1  = 0;
+        TCCR1B = (1 << CS10);             // avvia Timer1, F_CPU/1
+        BME280_compensate(&raw, &f);
+        TCCR1B = 0;
+        cyc_float += TCNT1;
+
+        TCNT1  = 0;
+        TCCR1B = (1 << CS10);
+        BME280_compensate_fixed(&raw, &x);
+        TCCR1B = 0;
+        cyc_fixed += TCNT1;
+    }
+
+    char msg[80];
+    snprintf_P(msg, sizeof(msg), PSTR("BME280 compensation: float %lu cycles, fixed %lu cycles\r\n"),
+             (unsigned long)(cyc_float / runs), (unsigned long)(cyc_fixed / runs));
+    UART_putString(msg);
+}
+
 /* ------------------------------------------------------------
    PROXY_init()
    - Inizializza UART, I2C, BME280, OLED e pulsanti 
@@ -157,37 +537,170 @@ static void PROXY_configure(void) {
    - Mostra messaggio di benvenuto sul display
 ------------------------------------------------------------ */
 void PROXY_init(void) {
-    UART_init(UART_MYUBRR);
-    I2C_init();
-    BME280_init();
+    UART_init(UART_BAUD);
+    if (I2C_init(I2C_BUS_HZ))
+        UART_putString_P(PSTR("I2C: requested speed not supported, using 100 kHz\r\n"));
+    PROXY_sensor_init();
+    PROXY_load_events();
 
-    PROXY_configure();  
+    // Configurazione valida in EEPROM: avvio diretto, senza terminale
+    uint8_t interactive = PROXY_load_config();
+    if (interactive) {
+        PROXY_measure_i2c();
+        PROXY_measure_compensation();
+        PROXY_configure();
+    } else {
+        UART_putString_P(PSTR("Configuration restored from EEPROM (type 'config' to change it)\r\n"));
+        PROXY_report_config();
+    }
 
+    TIMER_init();   // dopo le misure con Timer1: la ISR del tick le falserebbe
     OLED_init();
     BUTTONS_init();
 
-    OLED_clear();
-    OLED_print_line(3, "       WELCOME!");
-    _delay_ms(2000);
+    if (interactive) {
+        OLED_clear();
+        OLED_blit_P(3, SCREENS_welcome, SCREENS_WELCOME_W);
+        OLED_flush();
+        _delay_ms(2000);
+    }
 }
 
+/* ------------------------------------------------------------
+   Voci del menù oltre ai valori (0-3: temperatura, pressione,
+   umidità, tutti)
+------------------------------------------------------------ */
+#define MENU_STATS 4
+#define MENU_GRAPH 5
+#define MENU_EXIT  6
+#define MENU_ITEMS 7
+
+#if SCREENS_MENU_ITEMS != MENU_ITEMS
+#error "voci del menù diverse da tools/screens/mkscreens.c"
+#endif
+
 /* ------------------------------------------------------------
    show_menu()
-   Mostra il menù principale sul display
+   Mostra il menù principale sul display: titolo e voci sono
+   bitmap pre-renderizzate (display/screens.h)
 ------------------------------------------------------------ */
 static void show_menu(uint8_t sel) {
-    OLED_clear();
-    OLED_print_line(0, "SELECT PARAMETER:");
-    OLED_print_line(2, (sel == 0) ? "--> Temperature" : "    Temperature");
-    OLED_print_line(3, (sel == 1) ? "--> Pressure"    : "    Pressure");
-    OLED_print_line(4, (sel == 2) ? "--> Humidity"    : "    Humidity");
-    OLED_print_line(5, (sel == 3) ? "--> All"         : "    All");
-    OLED_print_line(6, (sel == 4) ? "--> Exit"        : "    Exit");
+    OLED_blit_P(0, SCREENS_menu_title, SCREENS_MENU_TITLE_W);
+    for (uint8_t i = 0; i < MENU_ITEMS; i++)
+        OLED_blit_P(1 + i, SCREENS_menu[i][sel == i], SCREENS_MENU_W);
+}
+
+/* ------------------------------------------------------------
+   Log testuale non bloccante
+   Le richieste di log si accumulano in log_pending (una per
+   campione riportato, vedi PROXY_report()) e vengono inviate da PROXY_task_uart() solo
+   quando il buffer TX ha spazio per l'intero messaggio: con il
+   collegamento saturo più richieste si fondono in un unico
+   messaggio con i valori più recenti, senza fermare i task
+------------------------------------------------------------ */
+#define PROXY_LOG_LINE 32   // buffer di format_*(): 31 caratteri + '\0'
+#define PROXY_LOG_MAX  (3 * (PROXY_LOG_LINE - 1 + 2))   // 3 righe con "\r\n"
+
+static uint8_t  log_pending = 0;   // 1 + voce da inviare, 0 = nessuna
+static uint16_t log_dropped = 0;   // messaggi/pacchetti scartati o fusi
+
+static uint8_t PROXY_log(const char *s, uint8_t len) {
+    if (UART_tx_free() < len) {
+        if (log_dropped != 0xFFFF) log_dropped++;
+        return 1;
+    }
+    UART_write(s, len);
+    return 0;
+}
+
+static void PROXY_log_request(uint8_t sel) {
+    if (!log_enabled || log_format != LOG_TEXT || sel > 3) return;
+    if (log_pending && log_dropped != 0xFFFF) log_dropped++;   // fuso con il precedente
+    log_pending = sel + 1;
+}
+
+static uint8_t dump_active = 0;   // vedi PROXY_dump_start()
+
+static void PROXY_log_flush(void) {
+    if (!log_pending || dump_active || UART_tx_free() < PROXY_LOG_MAX) return;
+
+    uint8_t sel = log_pending - 1;
+    char msg[PROXY_LOG_MAX];
+    char *p = msg;
+    log_pending = 0;
+
+    if (sel == 0 || sel == 3) { format_temp(p, PROXY_LOG_LINE);  p += strlen(p); *p++ = '\r'; *p++ = '\n'; }
+    if (sel == 1 || sel == 3) { format_press(p, PROXY_LOG_LINE); p += strlen(p); *p++ = '\r'; *p++ = '\n'; }
+    if (sel == 2 || sel == 3) { format_hum(p, PROXY_LOG_LINE);   p += strlen(p); *p++ = '\r'; *p++ = '\n'; }
+    UART_write(msg, (uint8_t)(p - msg));
+}
+
+/* ------------------------------------------------------------
+   show_stats()
+   Statistiche della finestra scorrevole, due righe per canale:
+   media e deviazione standard, poi minimo e massimo
+------------------------------------------------------------ */
+static void show_stats(void) {
+    static const char labels[STATS_CH_COUNT] PROGMEM = { 'T', 'P', 'H' };
+    char line[24];
+    char *end = line + sizeof(line) - 1;
+    STATS_summary_t st;
+
+    OLED_print_line_P(0, PSTR("STATS LAST 10 MIN"));
+    uint8_t empty = STATS_get(STATS_WIN_SLIDING, STATS_CH_TEMP, &st);
+    snprintf_P(line, sizeof(line), PSTR("n %lu"), empty ? 0UL : (unsigned long)st.n);
+    OLED_print_line(1, line);
+
+    for (uint8_t ch = 0; ch < STATS_CH_COUNT; ch++) {
+        char *p = line;
+        if (STATS_get(STATS_WIN_SLIDING, ch, &st)) {
+            OLED_print_line_P(2 + 2 * ch, PSTR(""));
+            OLED_print_line_P(3 + 2 * ch, PSTR(""));
+            continue;
+        }
+        *p++ = pgm_read_byte(&labels[ch]);
+        p = fmt_stat_value(p, end, ch, st.mean, 0, 8);
+        p = append_P(p, end, PSTR(" sd"));
+        p = fmt_stat_value(p, end, ch, st.stddev, 1, 6);
+        *p = '\0';
+        OLED_print_line(2 + 2 * ch, line);
+
+        p = line;
+        p = fmt_stat_value(p, end, ch, st.min, 0, 9);
+        p = append_P(p, end, PSTR(".."));
+        p = fmt_stat_value(p, end, ch, st.max, 0, 0);
+        *p = '\0';
+        OLED_print_line(3 + 2 * ch, line);
+    }
+}
+
+/* ------------------------------------------------------------
+   show_graph()
+   Canale e ultimo valore sulla riga 0, andamento sotto
+   (src/graph: a ogni campione cambiano solo due colonne)
+------------------------------------------------------------ */
+static void show_graph(void) {
+    static const char labels[STATS_CH_COUNT] PROGMEM = { 'T', 'P', 'H' };
+    const int32_t x[STATS_CH_COUNT] = {
+        TEMP_CENTI(last_temp), PRESS_PA(last_press), HUM_CENTI(last_hum)
+    };
+    uint8_t ch = GRAPH_channel();
+    char line[24];
+    char *end = line + sizeof(line) - 1;
+    char *p = line;
+
+    *p++ = pgm_read_byte(&labels[ch]);
+    p = fmt_stat_value(p, end, ch, x[ch], 0, 8);
+    p = append_P(p, end, stat_unit_P(ch));
+    *p = '\0';
+    OLED_print_line(0, line);
+    GRAPH_draw();
 }
 
 /* ------------------------------------------------------------
    show_value()
-   Mostra i valori e li invia sulla seriale
+   Mostra i valori; ridisegnata a ogni campione (il log seriale
+   è gestito dal campionamento, vedi PROXY_report())
 ------------------------------------------------------------ */
 static void show_value(uint8_t sel) {
     char tbuf[32], pbuf[32], hbuf[32];
@@ -197,86 +710,757 @@ static void show_value(uint8_t sel) {
 
     if (sel == 3) {
         OLED_show_sensors(tbuf, pbuf, hbuf);
-        if (log_enabled) {
-            UART_putString(tbuf); UART_putString("\r\n");
-            UART_putString(pbuf); UART_putString("\r\n");
-            UART_putString(hbuf); UART_putString("\r\n");
-        }
     } else {
-        const char *msg = NULL;
-        if (sel == 0) msg = tbuf;
-        else if (sel == 1) msg = pbuf;
-        else if (sel == 2) msg = hbuf;
         OLED_show_sensor((sel == 0) ? tbuf : NULL,
                          (sel == 1) ? pbuf : NULL,
                          (sel == 2) ? hbuf : NULL);
-        if (log_enabled && msg) {
-            UART_putString(msg);
-            UART_putString("\r\n");
+    }
+}
+
+/* ------------------------------------------------------------
+   show_alarms()
+   Indicatore allarmi in alto a destra, su ogni schermata:
+   "!" seguito dai canali fuori soglia, in maiuscolo se sopra
+   la soglia alta e in minuscolo se sotto quella bassa
+------------------------------------------------------------ */
+static void show_alarms(void) {
+    char ind[EVT_CH_COUNT + 2];
+    uint8_t i = EVT_CH_COUNT + 1;
+
+    memset(ind, ' ', sizeof(ind) - 1);
+    ind[i] = '\0';
+    for (int8_t ch = EVT_CH_COUNT - 1; ch >= 0; ch--) {
+        uint8_t st = EVT_alarm_state(ch);
+        if (st == EVT_NORMAL) continue;
+        char c = pgm_read_byte(&evt_labels[ch]);
+        ind[--i] = (st == EVT_LOW) ? c + ('a' - 'A') : c;
+    }
+    if (i <= EVT_CH_COUNT) ind[--i] = '!';
+    OLED_print_at(0, OLED_CHARS - (EVT_CH_COUNT + 1), ind);
+}
+
+/* ------------------------------------------------------------
+   Stato dell'interfaccia utente (condiviso tra i task)
+------------------------------------------------------------ */
+static uint8_t ui_sel     = 0;   // voce selezionata nel menù
+static uint8_t ui_in_menu = 1;   // 1 = menù, 0 = schermata valori
+static uint8_t ui_dirty   = 1;   // la schermata va ridisegnata
+static uint8_t ui_exit    = 0;   // richiesta di uscita
+
+static uint8_t task_sample  = SCHED_INVALID;
+static uint8_t task_buttons = SCHED_INVALID;
+static uint8_t task_display = SCHED_INVALID;
+static uint8_t task_trigger = SCHED_INVALID;
+static uint8_t task_uart    = SCHED_INVALID;
+
+/* ------------------------------------------------------------
+   PROXY_report()
+   Report-by-exception di un campione (vedi src/events): in
+   binario con il collegamento saturo il pacchetto viene scartato
+   (il client rileva il salto di report_seq) e il riferimento
+   della banda morta non cambia, così si ritenta al campione
+   successivo; in testo la richiesta si fonde con quelle in attesa
+------------------------------------------------------------ */
+static uint16_t report_seq = 0;   // campioni riportati in binario
+
+static void PROXY_report(const HIST_sample_t *h, const int32_t *x) {
+    if (log_format == LOG_BINARY) {
+        if (TELEM_send_sample(report_seq++, h->ms, h->temp, h->press, h->hum)) {
+            if (log_dropped != 0xFFFF) log_dropped++;
+            return;
         }
+    } else {
+        PROXY_log_request(3);
     }
+    EVT_report_done(x, h->ms);
 }
 
 /* ------------------------------------------------------------
-   PROXY_run()
-   Ciclo principale con gestione menù e pulsanti
+   Eventi di soglia
+   I cambi di stato vengono accodati in alarm_pending e inviati
+   da PROXY_alarms_flush() (task UART) appena il buffer TX ha
+   spazio, anche con il log disattivato: sono rari e non vanno
+   persi. Se uno stato cambia di nuovo prima dell'invio parte
+   solo il più recente.
 ------------------------------------------------------------ */
-void PROXY_run(void) {
-    uint8_t sel = 0;
-    uint8_t in_menu = 1;
+static uint8_t  alarm_pending = 0;   // bit ch: evento da inviare
+static int32_t  alarm_value[EVT_CH_COUNT];
+static uint32_t alarm_ms[EVT_CH_COUNT];
 
-    show_menu(sel);
+static void PROXY_alarms_update(const int32_t *x, uint32_t ms) {
+    uint8_t changed = EVT_update_alarms(x);
+    if (!changed) return;
 
-    while (1) {
-        
-        last_temp  = BME280_read_temperature();
-        last_press = BME280_read_pressure();
-        last_hum   = BME280_read_humidity();
-
-        uint8_t btn = BUTTONS_read();
-
-        if (in_menu) {
-            if (btn == 1) {
-                sel = (sel + 1) % 5;
-                show_menu(sel);
-            } else if (btn == 2) {
-                if (sel == 4) {
-                    UART_putString("================================================================================\r\n\r\n");
-                    UART_putString("\r\nExiting...\r\n");
-                    OLED_clear();
-                    OLED_print_line(3, "     GOODBYE! :)");
-                    _delay_ms(2000);
-                    OLED_clear();
-                    UART_putString("Exit complete. Goodbye! :)\r\n");
-                    _delay_ms(100);
-                    return;
-                } else {
-                    show_value(sel);
-                    in_menu = 0;
-                }
-            }
+    for (uint8_t ch = 0; ch < EVT_CH_COUNT; ch++) {
+        if (!(changed & (1 << ch))) continue;
+        alarm_value[ch] = x[ch];
+        alarm_ms[ch] = ms;
+    }
+    alarm_pending |= changed;
+    ui_dirty = 1;   // aggiorna l'indicatore sul display
+    SCHED_trigger(task_display);
+}
+
+static void PROXY_alarms_flush(void) {
+    if (!alarm_pending || dump_active) return;
+
+    for (uint8_t ch = 0; ch < EVT_CH_COUNT; ch++) {
+        if (!(alarm_pending & (1 << ch))) continue;
+        uint8_t st = EVT_alarm_state(ch);
+
+        if (log_format == LOG_BINARY) {
+            if (TELEM_send_event(ch, st, alarm_ms[ch], alarm_value[ch])) return;
         } else {
-            if (btn == 1 || btn == 2) {
-                in_menu = 1;
-                show_menu(sel);
+            char msg[56];
+            char *end = msg + sizeof(msg) - 1;
+            char *p = append_P(msg, end, PSTR("ALARM "));
+            *p++ = pgm_read_byte(&evt_labels[ch]);
+            *p++ = ' ';
+            p = append_P(p, end, evt_states[st]);
+            *p++ = ' ';
+            p = fmt_fixed(p, end, alarm_value[ch], 2, 0);
+            p = append_P(p, end, evt_units[ch]);
+            p += snprintf_P(p, end - p, PSTR(" @ %lu ms\r\n"), (unsigned long)alarm_ms[ch]);
+
+            uint8_t n = (uint8_t)(p - msg);
+            if (UART_tx_free() < n) return;
+            UART_write(msg, n);
+        }
+        alarm_pending &= ~(1 << ch);
+    }
+}
+
+/* ------------------------------------------------------------
+   PROXY_task_sample()
+   Legge il sensore solo quando ha terminato una nuova
+   conversione (una lettura per campione, non per giro)
+------------------------------------------------------------ */
+static void PROXY_task_sample(void) {
+    if (!BME280_data_ready()) return;
+
+#if PROXY_FIXED_POINT
+    BME280_fixed_t d;
+    if (BME280_read_all_fixed(&d) == 0) {
+#else
+    BME280_data_t d;
+    if (BME280_read_all(&d) == 0) {
+#endif
+        last_temp  = d.temperature;
+        last_press = d.pressure;
+        last_hum   = d.humidity;
+        last_seq   = BME280_sequence();
+
+        HIST_sample_t h = {
+            TIMER_millis(), last_seq, (int16_t)TEMP_CENTI(last_temp),
+            (uint32_t)PRESS_PA(last_press), (uint16_t)HUM_CENTI(last_hum)
+        };
+        HIST_add(&h);
+        STATS_add(h.ms, h.temp, h.press, h.hum);
+
+        // Schermata valori aperta: aggiornamento dal vivo (il display
+        // ridisegna e invia solo i caratteri cambiati)
+        if (!ui_in_menu && (ui_sel <= 3 || ui_sel == MENU_GRAPH)) ui_dirty = 1;
+
+        const int32_t x[EVT_CH_COUNT] = { h.temp, h.press, h.hum };
+        GRAPH_add(x);
+        PROXY_alarms_update(x, h.ms);
+        if (log_enabled && EVT_report_due(x, h.ms)) PROXY_report(&h, x);
+    }
+}
+
+/* ------------------------------------------------------------
+   PROXY_task_trigger()
+   In low-power avvia una conversione forced (periodo = PROXY_period_ms())
+------------------------------------------------------------ */
+static void PROXY_task_trigger(void) {
+    if (low_power) BME280_trigger();
+}
+
+/* ------------------------------------------------------------
+   PROXY_task_power_report()
+   In low-power riporta duty cycle e latenza di risveglio
+   misurati nell'ultima finestra, poi la azzera
+------------------------------------------------------------ */
+static void PROXY_task_power_report(void) {
+    if (!low_power || !log_enabled) {
+        SCHED_reset_stats();
+        return;
+    }
+
+    uint16_t duty = SCHED_duty_permille();
+    char msg[80];
+    int n = snprintf_P(msg, sizeof(msg),
+             PSTR("Power: awake %u.%u%% | wake-up latency max %u us\r\n"),
+             duty / 10, duty % 10, SCHED_latency_max_us());
+    PROXY_log(msg, (uint8_t)n);
+    SCHED_reset_stats();
+}
+
+/* ------------------------------------------------------------
+   PROXY_task_buttons()
+   Legge i pulsanti e aggiorna lo stato del menù
+------------------------------------------------------------ */
+static void PROXY_task_buttons(void) {
+    uint8_t btn = BUTTONS_read();
+    if (!btn) return;
+
+    if (ui_in_menu) {
+        if (btn == 1) {
+            ui_sel = (ui_sel + 1) % MENU_ITEMS;
+        } else if (btn == 2) {
+            if (ui_sel == MENU_EXIT) { ui_exit = 1; return; }
+            if (ui_sel == MENU_GRAPH) GRAPH_invalidate();
+            ui_in_menu = 0;
+        }
+    } else if (ui_sel == MENU_GRAPH && btn == 1) {
+        GRAPH_select((GRAPH_channel() + 1) % STATS_CH_COUNT);   // canale successivo
+    } else {
+        ui_in_menu = 1;
+    }
+
+    ui_dirty = 1;
+    SCHED_trigger(task_display);
+}
+
+/* ------------------------------------------------------------
+   PROXY_task_display()
+   Ridisegna la schermata corrente (nel framebuffer) quando lo
+   stato cambia e invia al display un blocco di al più
+   OLED_FLUSH_CHUNK colonne cambiate per esecuzione: se resta
+   altro il task si riattiva al giro successivo dello scheduler,
+   dopo gli altri task scaduti. Un ridisegno completo non
+   ritarda così letture del sensore e pulsanti di più di un blocco
+------------------------------------------------------------ */
+static void PROXY_task_display(void) {
+    if (ui_dirty) {
+        ui_dirty = 0;
+        if (ui_in_menu)                show_menu(ui_sel);
+        else if (ui_sel == MENU_STATS) show_stats();
+        else if (ui_sel == MENU_GRAPH) show_graph();
+        else                           show_value(ui_sel);
+        show_alarms();
+    }
+
+    // Con un errore I2C (display assente) si ritenta solo al
+    // prossimo periodo, così in low-power la CPU può dormire
+    if (OLED_flush_step(OLED_FLUSH_CHUNK) == OLED_FLUSH_MORE) SCHED_trigger(task_display);
+}
+
+/* ------------------------------------------------------------
+   Interfaccia comandi su UART (non bloccante)
+   Una riga per comando, senza distinzione maiuscole/minuscole:
+     help
+     get [all|values|config|stats]
+     reset stats
+     stats
+     log on|off
+     set format text|bin
+     set rate 125|250|500|1000|profile
+     set unit t c|k|f
+     set unit p pa|bar
+     set profile 1-4
+     set power on|off
+     set deadband t|p|h V      banda morte (°C, hPa, %RH; 0 = ogni campione)
+     set silence S             report almeno ogni S secondi (0 = mai)
+     set alarm t|p|h L H [Y]   soglie bassa/alta e isteresi (default:
+                               la banda morta del canale)
+     set alarm t|p|h off
+     save      salva la configurazione corrente in EEPROM
+     config    ripete la configurazione guidata (bloccante)
+     dump raw|1m|15m [csv|bin]   invia un livello dello storico
+     baud N    passa a N baud (vedi PROXY_set_baud())
+     ping      risponde "pong"
+------------------------------------------------------------ */
+static char *next_token(char **s) {
+    char *p = *s;
+    while (*p == ' ' || *p == '\t') p++;
+    if (!*p) return NULL;
+
+    char *tok = p;
+    while (*p && *p != ' ' && *p != '\t') p++;
+    if (*p) *p++ = '\0';
+    *s = p;
+    return tok;
+}
+
+static uint8_t is_on_off(const char *s, uint8_t *out) {
+    if (!s) return 0;
+    if (!strcmp_P(s, PSTR("on")))  { *out = 1; return 1; }
+    if (!strcmp_P(s, PSTR("off"))) { *out = 0; return 1; }
+    return 0;
+}
+
+/* ------------------------------------------------------------
+   parse_fixed()
+   Legge un numero con al più dec decimali ("-1.5" → -150 con
+   dec = 2); ritorna 0 se valido
+------------------------------------------------------------ */
+static uint8_t parse_fixed(const char *s, uint8_t dec, int32_t *out) {
+    int32_t v = 0;
+    uint8_t neg = 0, dot = 0, frac = 0, digits = 0;
+
+    if (!s) return 1;
+    if (*s == '-') { neg = 1; s++; }
+    for (; *s; s++) {
+        if (*s == '.' && !dot) { dot = 1; continue; }
+        if (*s < '0' || *s > '9' || (dot && frac == dec) || v > 99999) return 1;
+        v = v * 10 + (*s - '0');
+        digits++;
+        frac += dot;
+    }
+    if (!digits) return 1;
+    while (frac++ < dec) v *= 10;
+    *out = neg ? -v : v;
+    return 0;
+}
+
+// Canale EVT_CH_* da "t", "p" o "h"; EVT_CH_COUNT se non valido
+static uint8_t parse_channel(const char *s) {
+    if (!s || s[1]) return EVT_CH_COUNT;
+    if (s[0] == 't') return EVT_CH_TEMP;
+    if (s[0] == 'p') return EVT_CH_PRESS;
+    if (s[0] == 'h') return EVT_CH_HUM;
+    return EVT_CH_COUNT;
+}
+
+static void PROXY_print_values(void) {
+    char buf[32];
+    format_temp(buf, sizeof(buf));  UART_putString(buf); UART_putString_P(PSTR("\r\n"));
+    format_press(buf, sizeof(buf)); UART_putString(buf); UART_putString_P(PSTR("\r\n"));
+    format_hum(buf, sizeof(buf));   UART_putString(buf); UART_putString_P(PSTR("\r\n"));
+}
+
+static void PROXY_print_stats(void) {
+    char msg[112];
+    uint16_t duty = SCHED_duty_permille();
+    snprintf_P(msg, sizeof(msg),
+             PSTR("Samples: %u | Loop max: %u us | Latency max: %u us | Awake: %u.%u%%\r\n"),
+             BME280_sequence(), SCHED_loop_max_us(), SCHED_latency_max_us(),
+             duty / 10, duty % 10);
+    UART_putString(msg);
+    snprintf_P(msg, sizeof(msg),
+             PSTR("Task max (us): sample %u | buttons %u | display %u | uart %u\r\n"),
+             SCHED_task_max_us(task_sample), SCHED_task_max_us(task_buttons),
+             SCHED_task_max_us(task_display), SCHED_task_max_us(task_uart));
+    UART_putString(msg);
+
+    UART_stats_t u;
+    UART_get_stats(&u);
+    snprintf_P(msg, sizeof(msg),
+             PSTR("UART: rx overrun %u | rx dropped %u | tx stalls %u | tx short %u | log dropped %u\r\n"),
+             u.rx_overrun, u.rx_dropped, u.tx_stalls, u.tx_short, log_dropped);
+    UART_putString(msg);
+}
+
+/* ------------------------------------------------------------
+   PROXY_print_summary()
+   Statistiche di una finestra, una riga per canale
+------------------------------------------------------------ */
+static void PROXY_print_summary(uint8_t window) {
+    static const char names[STATS_CH_COUNT][12] PROGMEM = {
+        "Temperature", "Pressure", "Humidity"
+    };
+    char msg[112];
+    char *end = msg + sizeof(msg) - 1;
+    STATS_summary_t st;
+
+    if (window == STATS_WIN_SESSION)
+        snprintf_P(msg, sizeof(msg), PSTR("Stats since %lu s:\r\n"),
+                   (unsigned long)(STATS_session_start_ms() / 1000));
+    else
+        snprintf_P(msg, sizeof(msg), PSTR("Stats last %u min:\r\n"),
+                   (unsigned)(STATS_SLIDE_BLOCKS * STATS_BLOCK_S / 60));
+    UART_putString(msg);
+
+    for (uint8_t ch = 0; ch < STATS_CH_COUNT; ch++) {
+        char *p = msg;
+        p = append_P(p, end, PSTR("  "));
+        p = append_P(p, end, names[ch]);
+        if (STATS_get(window, ch, &st)) {
+            p = append_P(p, end, PSTR(": no samples"));
+        } else {
+            p += snprintf_P(p, end - p, PSTR(": n %lu | min "), (unsigned long)st.n);
+            p = fmt_stat_value(p, end, ch, st.min, 0, 0);
+            p = append_P(p, end, PSTR(" | mean "));
+            p = fmt_stat_value(p, end, ch, st.mean, 0, 0);
+            p = append_P(p, end, PSTR(" | max "));
+            p = fmt_stat_value(p, end, ch, st.max, 0, 0);
+            p = append_P(p, end, PSTR(" | sd "));
+            p = fmt_stat_value(p, end, ch, st.stddev, 1, 0);
+            p = append_P(p, end, stat_unit_P(ch));
+        }
+        p = append_P(p, end, PSTR("\r\n"));
+        *p = '\0';
+        UART_putString(msg);
+    }
+}
+
+/* ------------------------------------------------------------
+   PROXY_set_rate()
+   Cambia la frequenza di campionamento senza riavvio.
+   ms = 0 ripristina il tempo di standby del profilo corrente
+------------------------------------------------------------ */
+static uint8_t PROXY_set_rate(uint16_t ms) {
+    if (ms != 0 && ms != 125 && ms != 250 && ms != 500 && ms != 1000) return 1;
+    sampling_ms = ms;
+    if (ms) BME280_set_sampling(ms);
+    else    BME280_apply_profile(sensor_profile);
+    SCHED_set_period(task_trigger, PROXY_period_ms());
+    return 0;
+}
+
+/* ------------------------------------------------------------
+   PROXY_set_baud()
+   Negoziazione della velocità: il client invia "baud N" alla
+   velocità corrente, riceve "BAUD N OK", passa a N e invia
+   "ping". Se entro PROXY_BAUD_CONFIRM_MS non arriva un "ping"
+   valido il firmware torna alla velocità precedente, così un
+   collegamento che non regge la nuova velocità si ripristina
+   da solo.
+------------------------------------------------------------ */
+static uint32_t baud_prev = 0;       // != 0: cambio in attesa di conferma
+static uint32_t baud_switch_ms = 0;
+
+static void PROXY_set_baud(uint32_t baud) {
+    if (UART_baud_valid(baud)) {
+        UART_putString_P(PSTR("ERR: unsupported baud rate\r\n"));
+        return;
+    }
+
+    char msg[24];
+    snprintf_P(msg, sizeof(msg), PSTR("BAUD %lu OK\r\n"), (unsigned long)baud);
+    UART_putString(msg);
+
+    if (!baud_prev) baud_prev = UART_get_baud();
+    UART_set_baud(baud);   // attende l'invio della risposta
+    baud_switch_ms = TIMER_millis();
+}
+
+static void PROXY_check_baud(void) {
+    if (baud_prev && TIMER_millis() - baud_switch_ms > PROXY_BAUD_CONFIRM_MS) {
+        UART_set_baud(baud_prev);
+        baud_prev = 0;
+    }
+}
+
+/* ------------------------------------------------------------
+   Invio dello storico (comando "dump")
+   Non bloccante: PROXY_dump_step() invia qualche elemento a
+   ogni giro del task UART, solo se il buffer TX ha spazio.
+   Gli elementi sono indicizzati in modo assoluto (HIST_total()),
+   quindi quelli sovrascritti durante l'invio vengono saltati
+   invece di essere inviati fuori ordine.
+------------------------------------------------------------ */
+#define PROXY_DUMP_LINE_MAX 96   // riga CSV più lunga (intervalli)
+#define PROXY_DUMP_PER_STEP 4
+
+static uint8_t  dump_tier;
+static uint8_t  dump_bin;
+static uint32_t dump_next, dump_end;
+static uint16_t dump_sent;
+
+static const char tier_names[HIST_TIER_COUNT][4] PROGMEM = { "raw", "1m", "15m" };
+
+static void PROXY_dump_start(const char *tier, const char *fmt) {
+    uint8_t t;
+    for (t = 0; t < HIST_TIER_COUNT; t++)
+        if (!strcmp_P(tier, tier_names[t])) break;
+
+    uint8_t bin = (log_format == LOG_BINARY);
+    if (fmt) {
+        if (!strcmp_P(fmt, PSTR("bin")))      bin = 1;
+        else if (!strcmp_P(fmt, PSTR("csv"))) bin = 0;
+        else t = HIST_TIER_COUNT;
+    }
+    if (t == HIST_TIER_COUNT) {
+        UART_putString_P(PSTR("ERR: usage dump raw|1m|15m [csv|bin]\r\n"));
+        return;
+    }
+
+    dump_tier = t;
+    dump_bin  = bin;
+    dump_end  = HIST_total(t);
+    dump_next = dump_end - HIST_count(t);
+    dump_sent = 0;
+    dump_active = 1;
+
+    char name[4];
+    char msg[40];
+    strcpy_P(name, tier_names[t]);
+    snprintf_P(msg, sizeof(msg), PSTR("DUMP %s %u %s\r\n"),
+               name, (unsigned)(dump_end - dump_next), bin ? "bin" : "csv");
+    UART_putString(msg);
+    if (bin) return;
+
+    if (t == HIST_TIER_RAW)
+        UART_putString_P(PSTR("seq,ms,temperature_c,pressure_pa,humidity_rh\r\n"));
+    else
+        UART_putString_P(PSTR("start_s,n,t_min,t_avg,t_max,p_min_hpa,p_avg_hpa,p_max_hpa,h_min,h_avg,h_max\r\n"));
+}
+
+// Formatta un elemento in CSV; ritorna la lunghezza
+static uint8_t PROXY_dump_csv(char *buf, uint32_t k) {
+    char *p = buf, *end = buf + PROXY_DUMP_LINE_MAX - 1;
+
+    if (dump_tier == HIST_TIER_RAW) {
+        HIST_sample_t r;
+        HIST_get_raw(k, &r);
+        p += snprintf_P(p, end - p, PSTR("%u,%lu,"), r.seq, (unsigned long)r.ms);
+        p = fmt_fixed(p, end, r.temp, 2, 0);  *p++ = ',';
+        p = fmt_fixed(p, end, r.press, 0, 0); *p++ = ',';
+        p = fmt_fixed(p, end, r.hum, 2, 0);
+    } else {
+        HIST_bucket_t b;
+        HIST_get_bucket(dump_tier, k, &b);
+        const int32_t v[9] = {
+            b.t_min, b.t_avg, b.t_max,   // centesimi di °C
+            b.p_min, b.p_avg, b.p_max,   // decimi di hPa
+            b.h_min, b.h_avg, b.h_max    // centesimi di %RH
+        };
+        p += snprintf_P(p, end - p, PSTR("%lu,%u"), (unsigned long)b.start_s, b.n);
+        for (uint8_t i = 0; i < 9; i++) {
+            *p++ = ',';
+            p = fmt_fixed(p, end, v[i], (i >= 3 && i < 6) ? 1 : 2, 0);
+        }
+    }
+    *p++ = '\r'; *p++ = '\n';
+    return (uint8_t)(p - buf);
+}
+
+static void PROXY_dump_step(void) {
+    if (!dump_active) return;
+
+    for (uint8_t i = 0; i < PROXY_DUMP_PER_STEP && dump_next < dump_end; i++) {
+        uint32_t oldest = HIST_total(dump_tier) - HIST_count(dump_tier);
+        if (dump_next < oldest) dump_next = oldest;   // sovrascritti nel frattempo
+        if (dump_next >= dump_end) break;
+
+        if (dump_bin) {
+            uint8_t st;
+            if (dump_tier == HIST_TIER_RAW) {
+                HIST_sample_t r;
+                HIST_get_raw(dump_next, &r);
+                st = TELEM_send_raw(&r);
+            } else {
+                HIST_bucket_t b;
+                HIST_get_bucket(dump_tier, dump_next, &b);
+                st = TELEM_send_bucket(dump_tier, &b);
             }
+            if (st) return;   // nessuno spazio: si riprova al prossimo giro
+        } else {
+            if (UART_tx_free() < PROXY_DUMP_LINE_MAX) return;
+            char line[PROXY_DUMP_LINE_MAX + 1];
+            UART_write(line, PROXY_dump_csv(line, dump_next));
         }
+        dump_next++;
+        dump_sent++;
+    }
 
-        _delay_ms(10);
+    if (dump_next >= dump_end && UART_tx_free() >= 24) {
+        char msg[24];
+        uint8_t n = snprintf_P(msg, sizeof(msg), PSTR("DUMP END %u\r\n"), dump_sent);
+        UART_write(msg, n);
+        dump_active = 0;
     }
 }
 
+/* ------------------------------------------------------------
+   PROXY_exec_set()
+   Esegue "set <param> ..."; ritorna 0 se eseguito, 1 se non valido
+   rest: argomenti oltre a2 (solo "set alarm")
+------------------------------------------------------------ */
+static uint8_t PROXY_exec_set(char *param, char *a1, char *a2, char *rest) {
+    uint8_t on;
+    if (!param || !a1) return 1;
 
+    if (!strcmp_P(param, PSTR("rate"))) {
+        if (!strcmp_P(a1, PSTR("profile"))) return PROXY_set_rate(0);
+        uint16_t ms = atoi(a1);
+        return ms ? PROXY_set_rate(ms) : 1;
+    }
 
+    if (!strcmp_P(param, PSTR("format"))) {
+        if (!strcmp_P(a1, PSTR("text")))     log_format = LOG_TEXT;
+        else if (!strcmp_P(a1, PSTR("bin"))) log_format = LOG_BINARY;
+        else return 1;
+        return 0;
+    }
 
+    if (!strcmp_P(param, PSTR("unit")) && a2) {
+        if (!strcmp_P(a1, PSTR("t"))) {
+            if (!strcmp_P(a2, PSTR("c")))      temp_unit = UNIT_C;
+            else if (!strcmp_P(a2, PSTR("k"))) temp_unit = UNIT_K;
+            else if (!strcmp_P(a2, PSTR("f"))) temp_unit = UNIT_F;
+            else return 1;
+        } else if (!strcmp_P(a1, PSTR("p"))) {
+            if (!strcmp_P(a2, PSTR("pa")))       press_unit = UNIT_PA;
+            else if (!strcmp_P(a2, PSTR("bar"))) press_unit = UNIT_BAR;
+            else return 1;
+        } else {
+            return 1;
+        }
+        ui_dirty = 1;   // aggiorna la schermata valori
+        return 0;
+    }
 
+    if (!strcmp_P(param, PSTR("profile"))) {
+        int opt = atoi(a1);
+        if (opt < 1 || opt > BME280_PROFILE_COUNT) return 1;
+        sensor_profile = opt - 1;
+        BME280_apply_profile(sensor_profile);
+        if (sampling_ms) BME280_set_sampling(sampling_ms);   // "set rate" prevale sul profilo
+        SCHED_set_period(task_trigger, PROXY_period_ms());
+        return 0;
+    }
 
+    if (!strcmp_P(param, PSTR("power")) && is_on_off(a1, &on)) {
+        PROXY_set_low_power(on);
+        return 0;
+    }
 
+    EVT_config_t c;
+    EVT_get_config(&c);
+    uint8_t ch = parse_channel(a1);
+    int32_t v;
 
+    if (!strcmp_P(param, PSTR("silence"))) {
+        if (parse_fixed(a1, 0, &v) || v < 0 || v > 0xFFFF) return 1;
+        c.max_silence_s = (uint16_t)v;
+        return EVT_set_config(&c);
+    }
 
+    if (!strcmp_P(param, PSTR("deadband")) && ch < EVT_CH_COUNT) {
+        if (parse_fixed(a2, 2, &v) || v < 0 || v > 0xFFFF) return 1;
+        c.deadband[ch] = (uint16_t)v;
+        return EVT_set_config(&c);
+    }
 
+    if (!strcmp_P(param, PSTR("alarm")) && ch < EVT_CH_COUNT && a2) {
+        if (!strcmp_P(a2, PSTR("off"))) {
+            c.alarm_mask &= ~(1 << ch);
+        } else {
+            char *a3 = next_token(&rest);
+            char *a4 = next_token(&rest);
+            int32_t hyst = c.deadband[ch];
+            if (parse_fixed(a2, 2, &c.low[ch]) || parse_fixed(a3, 2, &c.high[ch]) ||
+                (a4 && parse_fixed(a4, 2, &hyst)) || hyst < 0 || hyst > 0xFFFF) return 1;
+            c.hyst[ch] = (uint16_t)hyst;
+            c.alarm_mask |= 1 << ch;
+        }
+        if (EVT_set_config(&c)) return 1;
+        ui_dirty = 1;   // un allarme disattivato sparisce dall'indicatore
+        return 0;
+    }
 
+    return 1;
+}
 
+/* ------------------------------------------------------------
+   PROXY_exec()
+   Interpreta ed esegue una riga di comando
+------------------------------------------------------------ */
+static void PROXY_exec(char *line) {
+    str_to_lower(line);
+    char *p = line;
+    char *cmd = next_token(&p);
+    char *a1  = next_token(&p);
+    char *a2  = next_token(&p);
+    char *a3  = next_token(&p);
+    uint8_t on;
+
+    if (!cmd) return;
+
+    if (!strcmp_P(cmd, PSTR("help"))) {
+        UART_putString_P(PSTR("Commands: get [all|values|config|stats] | reset stats | stats | log on|off\r\n"
+                              "  set rate 125|250|500|1000|profile | set format text|bin\r\n"
+                              "  set unit t c|k|f | set unit p pa|bar\r\n"
+                              "  set profile 1-4 | set power on|off | save | config\r\n"
+                              "  set deadband t|p|h V | set silence S\r\n"
+                              "  set alarm t|p|h LOW HIGH [HYST] | set alarm t|p|h off\r\n"
+                              "  dump raw|1m|15m [csv|bin] | baud N | ping\r\n"));
+    } else if (!strcmp_P(cmd, PSTR("get"))) {
+        uint8_t all = !a1 || !strcmp_P(a1, PSTR("all"));
+        if (all || !strcmp_P(a1, PSTR("values"))) PROXY_print_values();
+        if (all || !strcmp_P(a1, PSTR("config"))) PROXY_report_config();
+        if (all || !strcmp_P(a1, PSTR("stats"))) {
+            PROXY_print_summary(STATS_WIN_SESSION);
+            PROXY_print_summary(STATS_WIN_SLIDING);
+        }
+    } else if (!strcmp_P(cmd, PSTR("reset")) && a1 && !strcmp_P(a1, PSTR("stats"))) {
+        STATS_reset(TIMER_millis());
+        UART_putString_P(PSTR("OK\r\n"));
+    } else if (!strcmp_P(cmd, PSTR("stats"))) {
+        PROXY_print_stats();
+    } else if (!strcmp_P(cmd, PSTR("log")) && is_on_off(a1, &on)) {
+        log_enabled = on;
+        UART_putString_P(PSTR("OK\r\n"));
+    } else if (!strcmp_P(cmd, PSTR("set")) && !PROXY_exec_set(a1, a2, a3, p)) {
+        UART_putString_P(PSTR("OK\r\n"));
+    } else if (!strcmp_P(cmd, PSTR("dump")) && a1) {
+        PROXY_dump_start(a1, a2);
+    } else if (!strcmp_P(cmd, PSTR("ping"))) {
+        baud_prev = 0;   // conferma un eventuale cambio di velocità
+        UART_putString_P(PSTR("pong\r\n"));
+    } else if (!strcmp_P(cmd, PSTR("baud")) && a1) {
+        PROXY_set_baud(strtoul(a1, NULL, 10));
+    } else if (!strcmp_P(cmd, PSTR("save"))) {
+        PROXY_save_config();
+        UART_putString_P(PSTR("OK\r\n"));
+    } else if (!strcmp_P(cmd, PSTR("config"))) {
+        PROXY_configure();   // i task restano fermi fino al termine
+        SCHED_set_period(task_trigger, PROXY_period_ms());
+        SCHED_reset_stats();
+        ui_dirty = 1;
+    } else {
+        UART_putString_P(PSTR("ERR: invalid command (type 'help')\r\n"));
+    }
+}
+
+/* ------------------------------------------------------------
+   PROXY_task_uart()
+   Esegue i comandi ricevuti, una riga completa alla volta,
+   prosegue l'invio dello storico, invia eventi e log in attesa e
+   annulla i cambi di velocità non confermati
+------------------------------------------------------------ */
+static void PROXY_task_uart(void) {
+    char line[UART_LINE_MAX];
+    int n = UART_poll_line(line, sizeof(line));
+    if (n > 0) PROXY_exec(line);
+    else if (n == UART_LINE_OVERFLOW) UART_putString_P(PSTR("ERR: line too long\r\n"));
+    PROXY_dump_step();
+    PROXY_alarms_flush();
+    PROXY_log_flush();
+    PROXY_check_baud();
+}
 
+/* ------------------------------------------------------------
+   PROXY_run()
+   Ciclo principale: scheduler cooperativo con i task di
+   campionamento, lettura pulsanti e aggiornamento display
+------------------------------------------------------------ */
+void PROXY_run(void) {
+    task_sample  = SCHED_add(PROXY_task_sample,  PROXY_SAMPLE_POLL_MS);
+    task_buttons = SCHED_add(PROXY_task_buttons, PROXY_BUTTONS_MS);
+    task_display = SCHED_add(PROXY_task_display, PROXY_DISPLAY_MS);
+    task_trigger = SCHED_add(PROXY_task_trigger, PROXY_period_ms());
+    task_uart    = SCHED_add(PROXY_task_uart,    PROXY_UART_MS);
+    uint8_t task_report = SCHED_add(PROXY_task_power_report, PROXY_POWER_REPORT_MS);
+    SCHED_set_period(task_report, PROXY_POWER_REPORT_MS);   // primo report dopo un periodo intero
+    SCHED_reset_stats();
 
+    while (!ui_exit) {
+        SCHED_run_pending();
+        if (low_power) SCHED_idle();
+    }
 
+    UART_putString_P(PSTR("================================================================================\r\n\r\n"));
+    UART_putString_P(PSTR("\r\nExiting...\r\n"));
+    OLED_clear();
+    OLED_blit_P(3, SCREENS_goodbye, SCREENS_GOODBYE_W);
+    OLED_flush();
+    _delay_ms(2000);
+    OLED_clear();
+    OLED_flush();
+    UART_putString_P(PSTR("Exit complete. Goodbye! :)\r\n"));
+    _delay_ms(100);
+}
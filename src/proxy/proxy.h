@@ -2,6 +2,17 @@
 
 #include <stdint.h>
 
+/* ------------------------------------------------------------
+   PROXY_FIXED_POINT
+   1: campionamento con l'API BME280 in virgola fissa
+      (nessun float né int64 nel percorso di campionamento)
+   0: API float originale
+   Ridefinibile in compilazione (es. -DPROXY_FIXED_POINT=0)
+------------------------------------------------------------ */
+#ifndef PROXY_FIXED_POINT
+#define PROXY_FIXED_POINT 1
+#endif
+
 /* ------------------------------------------------------------
    Tipi di configurazione proxy
 ------------------------------------------------------------ */
@@ -16,6 +27,11 @@ typedef enum {
     UNIT_BAR = 1   // Bar
 } press_unit_t;
 
+typedef enum {
+    LOG_TEXT   = 0,  // righe leggibili alla visualizzazione dei valori
+    LOG_BINARY = 1   // pacchetti COBS a ogni campione (vedi telemetry.h)
+} log_format_t;
+
 /* ------------------------------------------------------------
    Inizializza UART, I2C, sensore, OLED e pulsanti
 ------------------------------------------------------------ */
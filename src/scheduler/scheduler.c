@@ -0,0 +1,156 @@
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+
+#include "../../avr_common/timer/timer.h"
+#include "scheduler.h"
+
+/* ------------------------------------------------------------
+   Tabella dei task
+------------------------------------------------------------ */
+typedef struct {
+    SCHED_task_fn fn;
+    uint16_t      period_ms;
+    uint32_t      next_ms;     // istante della prossima esecuzione
+    uint16_t      max_us;      // durata massima osservata
+} SCHED_task_t;
+
+static SCHED_task_t tasks[SCHED_MAX_TASKS];
+static uint8_t  n_tasks = 0;
+static uint16_t loop_max_us = 0;
+static uint16_t latency_max_us = 0;   // ritardo massimo di avvio rispetto alla scadenza
+static uint32_t sleep_us = 0;         // tempo trascorso in sleep
+static uint32_t stats_start_us = 0;   // inizio della finestra statistiche
+
+/* ------------------------------------------------------------
+   SCHED_add()
+   Registra un task; la prima esecuzione è immediata
+------------------------------------------------------------ */
+uint8_t SCHED_add(SCHED_task_fn fn, uint16_t period_ms) {
+    if (n_tasks >= SCHED_MAX_TASKS) return SCHED_INVALID;
+
+    SCHED_task_t *t = &tasks[n_tasks];
+    t->fn        = fn;
+    t->period_ms = period_ms;
+    t->next_ms   = TIMER_millis();
+    t->max_us    = 0;
+    return n_tasks++;
+}
+
+/* ------------------------------------------------------------
+   SCHED_set_period()
+   Cambia il periodo di un task (effettivo dalla prossima esecuzione)
+------------------------------------------------------------ */
+void SCHED_set_period(uint8_t id, uint16_t period_ms) {
+    if (id >= n_tasks) return;
+    tasks[id].period_ms = period_ms;
+    tasks[id].next_ms   = TIMER_millis() + period_ms;
+}
+
+/* ------------------------------------------------------------
+   SCHED_trigger()
+   Rende il task immediatamente eseguibile
+------------------------------------------------------------ */
+void SCHED_trigger(uint8_t id) {
+    if (id >= n_tasks) return;
+    tasks[id].next_ms = TIMER_millis();
+}
+
+/* ------------------------------------------------------------
+   SCHED_run_pending()
+   Esegue i task il cui istante di attivazione è passato.
+   Il confronto con differenza con segno gestisce l'overflow
+   di TIMER_millis(). Se un task è in ritardo di più di un
+   periodo, le esecuzioni perse non vengono recuperate.
+------------------------------------------------------------ */
+void SCHED_run_pending(void) {
+    uint32_t loop_start = TIMER_micros();
+
+    for (uint8_t i = 0; i < n_tasks; i++) {
+        SCHED_task_t *t = &tasks[i];
+        uint32_t now = TIMER_millis();
+        if ((int32_t)(now - t->next_ms) < 0) continue;
+
+        uint32_t due_ms = t->next_ms;
+        t->next_ms += t->period_ms;
+        if ((int32_t)(now - t->next_ms) >= 0) t->next_ms = now + t->period_ms;
+
+        uint32_t start = TIMER_micros();
+        uint32_t late = start - due_ms * 1000UL;   // include il risveglio dallo sleep
+        if (late > 0xFFFF) late = 0xFFFF;
+        if (late > latency_max_us) latency_max_us = (uint16_t)late;
+
+        t->fn();
+        uint32_t dt = TIMER_micros() - start;
+        if (dt > 0xFFFF) dt = 0xFFFF;
+        if (dt > t->max_us) t->max_us = (uint16_t)dt;
+    }
+
+    uint32_t dt = TIMER_micros() - loop_start;
+    if (dt > 0xFFFF) dt = 0xFFFF;
+    if (dt > loop_max_us) loop_max_us = (uint16_t)dt;
+}
+
+/* ------------------------------------------------------------
+   SCHED_any_due()
+   1 se almeno un task è già scaduto
+------------------------------------------------------------ */
+static uint8_t SCHED_any_due(void) {
+    uint32_t now = TIMER_millis();
+    for (uint8_t i = 0; i < n_tasks; i++) {
+        if ((int32_t)(now - tasks[i].next_ms) >= 0) return 1;
+    }
+    return 0;
+}
+
+/* ------------------------------------------------------------
+   SCHED_idle()
+   Se nessun task è scaduto mette la CPU in modalità idle.
+   Il risveglio avviene con qualsiasi interrupt: tick di Timer2
+   (1 ms), pulsanti, ricezione UART, TWI.
+   Il controllo avviene a interrupt disabilitati: sei() seguita
+   da sleep_cpu() garantisce che un interrupt arrivato nel
+   frattempo non venga perso.
+------------------------------------------------------------ */
+void SCHED_idle(void) {
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    cli();
+    if (SCHED_any_due()) { sei(); return; }
+
+    uint32_t t0 = TIMER_micros();
+    sleep_enable();
+    sei();
+    sleep_cpu();
+    sleep_disable();
+    sleep_us += TIMER_micros() - t0;
+}
+
+/* ------------------------------------------------------------
+   Statistiche di latenza e duty cycle
+------------------------------------------------------------ */
+uint16_t SCHED_task_max_us(uint8_t id) {
+    return (id < n_tasks) ? tasks[id].max_us : 0;
+}
+
+uint16_t SCHED_loop_max_us(void) {
+    return loop_max_us;
+}
+
+uint16_t SCHED_latency_max_us(void) {
+    return latency_max_us;
+}
+
+// Frazione di tempo da sveglio nella finestra corrente (‰)
+uint16_t SCHED_duty_permille(void) {
+    uint32_t elapsed_ms = (TIMER_micros() - stats_start_us) / 1000;
+    if (!elapsed_ms) return 1000;
+    uint32_t asleep = sleep_us / elapsed_ms;   // us per ms = ‰
+    return (asleep >= 1000) ? 0 : (uint16_t)(1000 - asleep);
+}
+
+void SCHED_reset_stats(void) {
+    for (uint8_t i = 0; i < n_tasks; i++) tasks[i].max_us = 0;
+    loop_max_us = 0;
+    latency_max_us = 0;
+    sleep_us = 0;
+    stats_start_us = TIMER_micros();
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdint.h>
+
+/* ------------------------------------------------------------
+   Scheduler cooperativo a task periodici
+   Ogni task è una funzione che deve terminare in tempi brevi
+   (nessuna attesa attiva): lo scheduler la richiama ogni
+   period_ms millisecondi, basandosi su TIMER_millis().
+------------------------------------------------------------ */
+#define SCHED_MAX_TASKS 8
+#define SCHED_INVALID   0xFF
+
+typedef void (*SCHED_task_fn)(void);
+
+/* ------------------------------------------------------------
+   Registra un task periodico
+   Ritorna l'identificativo del task, SCHED_INVALID se pieno
+------------------------------------------------------------ */
+uint8_t SCHED_add(SCHED_task_fn fn, uint16_t period_ms);
+
+/* ------------------------------------------------------------
+   Modifica il periodo / forza l'esecuzione al prossimo giro
+------------------------------------------------------------ */
+void SCHED_set_period(uint8_t id, uint16_t period_ms);
+void SCHED_trigger(uint8_t id);
+
+/* ------------------------------------------------------------
+   Esegue una passata su tutti i task scaduti
+------------------------------------------------------------ */
+void SCHED_run_pending(void);
+
+/* ------------------------------------------------------------
+   Mette la CPU in idle finché un interrupt non la risveglia,
+   solo se nessun task è già scaduto
+------------------------------------------------------------ */
+void SCHED_idle(void);
+
+/* ------------------------------------------------------------
+   Statistiche (dall'ultimo SCHED_reset_stats())
+   - durata massima di un task (us)
+   - durata massima di una passata dello scheduler (us)
+   - ritardo massimo di avvio di un task rispetto alla sua
+     scadenza, incluso il risveglio dallo sleep (us)
+   - duty cycle: frazione di tempo da sveglio (‰)
+------------------------------------------------------------ */
+uint16_t SCHED_task_max_us(uint8_t id);
+uint16_t SCHED_loop_max_us(void);
+uint16_t SCHED_latency_max_us(void);
+uint16_t SCHED_duty_permille(void);
+void     SCHED_reset_stats(void);
@@ -1,4 +1,8 @@
+#include <string.h>
+#include <avr/pgmspace.h>
+
 #include "../../avr_common/i2c/i2c.h"
+#include "../../avr_common/timer/timer.h"
 #include "bme280.h"
 
 /* ------------------------------------------------------------
@@ -20,18 +24,33 @@ static int8_t   dig_H6;
 static int32_t t_fine;   // variabile di calibrazione temperatura
 
 /* ------------------------------------------------------------
-   Funzioni di supporto (lettura registri via I2C)
+   Stato del ciclo di conversione (modalità normale)
+   Una conversione dura t_meas, seguita da t_standby: il registro
+   di stato 0xF3 viene interrogato solo attorno alla fine prevista.
+   due_ms è l'istante entro il quale una nuova conversione è
+   sicuramente terminata: serve solo quando il fronte di
+   "measuring" non poteva essere osservato, cioè se tra due
+   controlli di 0xF3 è passato più di t_meas (task fermo)
 ------------------------------------------------------------ */
-static uint16_t BME280_read16(uint8_t reg) { //Serve per leggere i registri a 16 bit
-    uint8_t buf[2]; 
-    I2C_read_regs(BME280_ADDR, reg, buf, 2);
-    return ((uint16_t)buf[1] << 8) | buf[0]; 
-}
+#define BME280_STATUS_MEASURING 0x08   // bit 3 di 0xF3
 
-static int16_t BME280_readS16(uint8_t reg) {
-    return (int16_t)BME280_read16(reg);
-}
+static BME280_config_t cfg = {          // configurazione corrente
+    BME280_OS_X1, BME280_OS_X1, BME280_OS_X1, BME280_FILTER_OFF, BME280_STANDBY_0_5
+};
+static uint8_t  mode = BME280_MODE_NORMAL;
+static uint16_t standby_ms = 0;        // t_sb arrotondato per difetto (ms)
+static uint8_t  meas_ms = 1;           // t_meas arrotondato per eccesso (ms)
+static uint16_t period_ms = 1;         // t_meas + t_sb arrotondato per eccesso (ms)
+static uint32_t next_poll_ms = 0;      // prima del quale non serve interrogare
+static uint32_t due_ms = 0;            // fine sicura della prossima conversione
+static uint32_t last_poll_ms = 0;      // ultimo controllo di 0xF3
+static uint8_t  seen_measuring = 0;    // conversione in corso osservata
+static uint8_t  data_pending = 0;      // nuova conversione non ancora letta
+static uint16_t sample_seq = 0;        // numero di conversioni rilevate
 
+/* ------------------------------------------------------------
+   Funzioni di supporto (lettura registri via I2C)
+------------------------------------------------------------ */
 static int32_t BME280_read_raw_temp(void) { //Legge il valore grezzo della temperatura, 20 bit
     uint8_t buf[3];
     I2C_read_regs(BME280_ADDR, 0xFA, buf, 3);
@@ -51,105 +70,88 @@ static int32_t BME280_read_raw_hum(void) {
 }
 
 /* ------------------------------------------------------------
-   BME280_init()
-   Legge i coefficienti di calibrazione e configura il sensore:
-   - Oversampling x1 per temperatura, pressione e umidità
-   - Modalità "normal"
-   - Imposta i registri di configurazione base
+   Copia grezza dei registri di calibrazione, conservata per
+   la cache in EEPROM (BME280_get_calibration())
+   - [0..25]:  0x88..0xA1: T1..T3, P1..P9, H1
+   - [26..32]: 0xE1..0xE7: H2..H6
 ------------------------------------------------------------ */
-void BME280_init(void) {
+static uint8_t calib_raw[BME280_CALIB_LEN];
+static uint8_t calib_valid = 0;
+
+/* ------------------------------------------------------------
+   BME280_parse_calibration()
+   Ricava i coefficienti dalla copia grezza dei registri.
+   I valori a 16 bit sono memorizzati little-endian.
+------------------------------------------------------------ */
+static void BME280_parse_calibration(void) {
+    const uint8_t *c = calib_raw;
+    const uint8_t *h = calib_raw + 26;
+
     // ---- Coefficienti calibrazione temperatura ----
-    dig_T1 = BME280_read16(0x88); //0x88 e 0x89
-    dig_T2 = BME280_readS16(0x8A); //0x8A e 0x8B
-    dig_T3 = BME280_readS16(0x8C); //0x8C e 0x8D
+    dig_T1 = (uint16_t)((c[1] << 8) | c[0]);   // 0x88 e 0x89
+    dig_T2 = (int16_t)((c[3] << 8) | c[2]);    // 0x8A e 0x8B
+    dig_T3 = (int16_t)((c[5] << 8) | c[4]);    // 0x8C e 0x8D
 
     // ---- Coefficienti calibrazione pressione ----
-    dig_P1 = BME280_read16(0x8E);
-    dig_P2 = BME280_readS16(0x90);
-    dig_P3 = BME280_readS16(0x92);
-    dig_P4 = BME280_readS16(0x94);
-    dig_P5 = BME280_readS16(0x96);
-    dig_P6 = BME280_readS16(0x98);
-    dig_P7 = BME280_readS16(0x9A);
-    dig_P8 = BME280_readS16(0x9C);
-    dig_P9 = BME280_readS16(0x9E);
+    dig_P1 = (uint16_t)((c[7] << 8) | c[6]);   // 0x8E
+    dig_P2 = (int16_t)((c[9] << 8) | c[8]);
+    dig_P3 = (int16_t)((c[11] << 8) | c[10]);
+    dig_P4 = (int16_t)((c[13] << 8) | c[12]);
+    dig_P5 = (int16_t)((c[15] << 8) | c[14]);
+    dig_P6 = (int16_t)((c[17] << 8) | c[16]);
+    dig_P7 = (int16_t)((c[19] << 8) | c[18]);
+    dig_P8 = (int16_t)((c[21] << 8) | c[20]);
+    dig_P9 = (int16_t)((c[23] << 8) | c[22]);  // 0x9E e 0x9F
 
     // ---- Coefficienti calibrazione umidità ----
-    {
-        uint8_t tmp;
-        I2C_read_reg(BME280_ADDR, 0xA1, &tmp);
-        dig_H1 = tmp;
-    }
-
-    dig_H2 = BME280_readS16(0xE1);
-
-    {
-        uint8_t tmp;
-        I2C_read_reg(BME280_ADDR, 0xE3, &tmp);
-        dig_H3 = tmp;
-    }
-
-    {
-        uint8_t e4, e5, e6;
-        I2C_read_reg(BME280_ADDR, 0xE4, &e4);
-        I2C_read_reg(BME280_ADDR, 0xE5, &e5);
-        I2C_read_reg(BME280_ADDR, 0xE6, &e6);
-        dig_H4 = (int16_t)((e4 << 4) | (e5 & 0x0F));
-        dig_H5 = (int16_t)((e6 << 4) | (e5 >> 4));
-    }
-
-    {
-        uint8_t tmp;
-        I2C_read_reg(BME280_ADDR, 0xE7, &tmp);
-        dig_H6 = (int8_t)tmp;
-    }
-
-    // ---- Configurazione sensore ----
-    I2C_write_reg(BME280_ADDR, 0xF2, 0x01);   // ctrl_hum: oversampling x1
-    I2C_write_reg(BME280_ADDR, 0xF4, 0x27);   // ctrl_meas: temp+press x1, normal mode
+    dig_H1 = c[25];                            // 0xA1 (0xA0 non usato)
+    dig_H2 = (int16_t)((h[1] << 8) | h[0]);    // 0xE1 e 0xE2
+    dig_H3 = h[2];                             // 0xE3
+    dig_H4 = (int16_t)(((int16_t)(int8_t)h[3] << 4) | (h[4] & 0x0F));  // 0xE4, 0xE5[3:0]
+    dig_H5 = (int16_t)(((int16_t)(int8_t)h[5] << 4) | (h[4] >> 4));    // 0xE6, 0xE5[7:4]
+    dig_H6 = (int8_t)h[6];                     // 0xE7
 }
 
 /* ------------------------------------------------------------
-   BME280_set_sampling()
-   Imposta il tempo di standby (sampling rate interno)
-   secondo il valore scelto dall'utente in millisecondi.
+   BME280_load_calibration()
+   Legge tutti i coefficienti di calibrazione in due sole
+   transazioni I2C (burst):
+   - 0x88..0xA1 (26 byte): T1..T3, P1..P9, H1
+   - 0xE1..0xE7 (7 byte):  H2..H6
 ------------------------------------------------------------ */
-void BME280_set_sampling(uint16_t ms) {
-    uint8_t config_val = 0x00;
+static uint8_t BME280_load_calibration(void) {
+    uint8_t st;
 
-    if (ms == 125)       config_val = 0x40; // 125 ms
-    else if (ms == 250)  config_val = 0x60; // 250 ms
-    else if (ms == 500)  config_val = 0x80; // 500 ms
-    else                 config_val = 0xA0; // 1000 ms
+    calib_valid = 0;
+    st = I2C_read_regs(BME280_ADDR, 0x88, calib_raw, 26);
+    if (st) return st;
+    st = I2C_read_regs(BME280_ADDR, 0xE1, calib_raw + 26, 7);
+    if (st) return st;
 
-    I2C_write_reg(BME280_ADDR, 0xF5, config_val);
+    BME280_parse_calibration();
+    calib_valid = 1;
+    return 0;
 }
 
 /* ------------------------------------------------------------
-   BME280_read_temperature()
-   Legge la temperatura compensata in °C
-   - Usa le formule Bosch originali con i coefficienti letti
-   - Aggiorna la variabile t_fine (usata anche per P e H)
+   Compensazione (formule Bosch) a partire dai valori grezzi
 ------------------------------------------------------------ */
-float BME280_read_temperature(void) {
-    int32_t adc_T = BME280_read_raw_temp();
+// Temperatura in centesimi di °C (aggiorna t_fine)
+static int32_t BME280_compensate_temperature_int(int32_t adc_T) {
     int32_t var1, var2;
     var1 = ((((adc_T >> 3) - ((int32_t)dig_T1 << 1))) * (int32_t)dig_T2) >> 11;
     var2 = (((((adc_T >> 4) - (int32_t)dig_T1) *
               ((adc_T >> 4) - (int32_t)dig_T1)) >> 12) *
             (int32_t)dig_T3) >> 14;
     t_fine = var1 + var2;
-    return ((t_fine * 5 + 128) >> 8) / 100.0f;
+    return (t_fine * 5 + 128) >> 8;
 }
 
-/* ------------------------------------------------------------
-   BME280_read_pressure()
-   Legge la pressione compensata in hPa
-   - Richiede t_fine calcolato in precedenza
-   - Esegue la formula di compensazione intera a 64 bit
------------------------------------------------------------- */
-float BME280_read_pressure(void) {
-    int32_t adc_P = BME280_read_raw_press();
+static float BME280_compensate_temperature(int32_t adc_T) {
+    return BME280_compensate_temperature_int(adc_T) / 100.0f;
+}
+
+static float BME280_compensate_pressure(int32_t adc_P) {
     int64_t var1, var2, p;
     var1 = ((int64_t)t_fine) - 128000;
     var2 = var1 * var1 * (int64_t)dig_P6;
@@ -166,14 +168,28 @@ float BME280_read_pressure(void) {
     return (float)p / 25600.0f;  // hPa
 }
 
-/* ------------------------------------------------------------
-   BME280_read_humidity()
-   Legge l’umidità relativa compensata in %RH
-   - Richiede t_fine calcolato dalla temperatura
-   - Applica compensazione secondo datasheet Bosch
------------------------------------------------------------- */
-float BME280_read_humidity(void) {
-    int32_t adc_H = BME280_read_raw_hum();
+// Pressione in Pa con la variante Bosch a 32 bit (nessun int64)
+static uint32_t BME280_compensate_pressure_int(int32_t adc_P) {
+    int32_t var1, var2;
+    uint32_t p;
+    var1 = (t_fine >> 1) - (int32_t)64000;
+    var2 = (((var1 >> 2) * (var1 >> 2)) >> 11) * (int32_t)dig_P6;
+    var2 = var2 + ((var1 * (int32_t)dig_P5) << 1);
+    var2 = (var2 >> 2) + ((int32_t)dig_P4 << 16);
+    var1 = ((((int32_t)dig_P3 * (((var1 >> 2) * (var1 >> 2)) >> 13)) >> 3) +
+            (((int32_t)dig_P2 * var1) >> 1)) >> 18;
+    var1 = ((32768 + var1) * (int32_t)dig_P1) >> 15;
+    if (var1 == 0) return 0;     // protezione da divisione per zero
+    p = ((uint32_t)((int32_t)1048576 - adc_P) - (uint32_t)(var2 >> 12)) * 3125;
+    if (p < 0x80000000UL) p = (p << 1) / (uint32_t)var1;
+    else                  p = (p / (uint32_t)var1) * 2;
+    var1 = ((int32_t)dig_P9 * (int32_t)(((p >> 3) * (p >> 3)) >> 13)) >> 12;
+    var2 = ((int32_t)(p >> 2) * (int32_t)dig_P8) >> 13;
+    return (uint32_t)((int32_t)p + ((var1 + var2 + dig_P7) >> 4));
+}
+
+// Umidità in %RH, formato Q22.10 (valore / 1024)
+static uint32_t BME280_compensate_humidity_int(int32_t adc_H) {
     int32_t v_x1_u32r;
     v_x1_u32r = t_fine - 76800;
     v_x1_u32r = (((((adc_H << 14) - ((int32_t)dig_H4 << 20) -
@@ -186,12 +202,375 @@ float BME280_read_humidity(void) {
                   (int32_t)dig_H1) >> 4);
     if (v_x1_u32r < 0) v_x1_u32r = 0;
     if (v_x1_u32r > 419430400) v_x1_u32r = 419430400;
-    return (v_x1_u32r >> 12) / 1024.0f;
+    return (uint32_t)(v_x1_u32r >> 12);
+}
+
+static float BME280_compensate_humidity(int32_t adc_H) {
+    return BME280_compensate_humidity_int(adc_H) / 1024.0f;
+}
+
+/* ------------------------------------------------------------
+   Tempo di standby (t_sb) in us per ciascun codice
+------------------------------------------------------------ */
+static const uint32_t standby_us[8] PROGMEM = {
+    500, 62500, 125000, 250000, 500000, 1000000, 10000, 20000
+};
+
+static uint32_t BME280_standby_us(void) {
+    return pgm_read_dword(&standby_us[cfg.standby]);
+}
+
+/* ------------------------------------------------------------
+   Profili predefiniti (oversampling T/P/H, filtro IIR, standby)
+   ispirati alle modalità consigliate dal datasheet (par. 3.5)
+------------------------------------------------------------ */
+static const BME280_config_t profiles[BME280_PROFILE_COUNT] PROGMEM = {
+    // Low-latency: x1 ovunque, nessun filtro, ~100 Hz
+    { BME280_OS_X1, BME280_OS_X1,  BME280_OS_X1, BME280_FILTER_OFF, BME280_STANDBY_0_5  },
+    // Balanced: rumore ridotto su T/P, ~7 Hz
+    { BME280_OS_X2, BME280_OS_X4,  BME280_OS_X1, BME280_FILTER_4,   BME280_STANDBY_125  },
+    // Low-noise (indoor navigation): P x16, IIR 16, ~21 Hz
+    { BME280_OS_X2, BME280_OS_X16, BME280_OS_X1, BME280_FILTER_16,  BME280_STANDBY_0_5  },
+    // Weather station: x1, nessun filtro, 1 Hz
+    { BME280_OS_X1, BME280_OS_X1,  BME280_OS_X1, BME280_FILTER_OFF, BME280_STANDBY_1000 },
+};
+
+/* ------------------------------------------------------------
+   BME280_write_config()
+   Scrive la configurazione corrente nel sensore:
+   - sleep, perché in modalità normale le scritture su 0xF5
+     possono essere ignorate
+   - ctrl_hum diventa effettivo solo dopo la scrittura di ctrl_meas
+   Riallinea il rilevamento delle conversioni.
+------------------------------------------------------------ */
+static uint8_t BME280_write_config(void) {
+    uint8_t st;
+    st = I2C_write_reg(BME280_ADDR, 0xF4, 0x00);                                  if (st) return st;
+    st = I2C_write_reg(BME280_ADDR, 0xF5, (cfg.standby << 5) | (cfg.filter << 2)); if (st) return st;
+    st = I2C_write_reg(BME280_ADDR, 0xF2, cfg.osrs_h);                            if (st) return st;
+    if (mode == BME280_MODE_NORMAL) {
+        st = I2C_write_reg(BME280_ADDR, 0xF4, (cfg.osrs_t << 5) | (cfg.osrs_p << 2) | 0x03);
+        if (st) return st;
+    }   // in modalità forced il sensore resta in sleep fino a BME280_trigger()
+
+    uint32_t t_meas = BME280_measure_time_us();
+    meas_ms    = (uint8_t)((t_meas + 999) / 1000);
+    standby_ms = (uint16_t)(BME280_standby_us() / 1000);
+    period_ms  = (uint16_t)((t_meas + BME280_standby_us() + 999) / 1000);
+    seen_measuring = 0;
+    data_pending = 0;
+    next_poll_ms = 0;   // riallinea la fase al prossimo controllo
+    last_poll_ms = TIMER_millis();
+    due_ms = last_poll_ms + meas_ms;   // la prima conversione parte subito
+    return 0;
+}
+
+/* ------------------------------------------------------------
+   BME280_init()
+   Legge i coefficienti di calibrazione e configura il sensore:
+   - Oversampling x1 per temperatura, pressione e umidità
+   - Filtro IIR disattivato
+   - Modalità "normal"
+------------------------------------------------------------ */
+void BME280_init(void) {
+    BME280_load_calibration();
+
+    // ---- Configurazione sensore ----
+    BME280_write_config();
 }
 
+/* ------------------------------------------------------------
+   BME280_init_cached()
+   Come BME280_init(), ma con i coefficienti salvati in
+   precedenza (BME280_get_calibration()). Per riconoscere un
+   sensore sostituito rilegge solo dig_T1 (2 byte) e lo
+   confronta con la copia: se diverso ritorna 1 senza
+   configurare il sensore, altrimenti 0 o il codice di errore I2C
+------------------------------------------------------------ */
+uint8_t BME280_init_cached(const uint8_t *calib) {
+    uint8_t t1[2];
+    uint8_t st = I2C_read_regs(BME280_ADDR, 0x88, t1, sizeof(t1));
+    if (st) return st;
+    if (t1[0] != calib[0] || t1[1] != calib[1]) return 1;
 
+    memcpy(calib_raw, calib, BME280_CALIB_LEN);
+    BME280_parse_calibration();
+    calib_valid = 1;
 
+    // ---- Configurazione sensore ----
+    return BME280_write_config();
+}
 
+/* ------------------------------------------------------------
+   BME280_get_calibration()
+   Copia i registri di calibrazione letti dal sensore;
+   ritorna 1 se non sono ancora stati letti
+------------------------------------------------------------ */
+uint8_t BME280_get_calibration(uint8_t *calib) {
+    if (!calib_valid) return 1;
+    memcpy(calib, calib_raw, BME280_CALIB_LEN);
+    return 0;
+}
 
+/* ------------------------------------------------------------
+   BME280_configure()
+   Applica oversampling, filtro IIR e standby
+   Ritorna 0 in caso di successo, 1 se un campo non è valido,
+   altrimenti il codice di errore I2C
+------------------------------------------------------------ */
+uint8_t BME280_configure(const BME280_config_t *c) {
+    if (c->osrs_t > BME280_OS_X16 || c->osrs_p > BME280_OS_X16 ||
+        c->osrs_h > BME280_OS_X16 || c->filter > BME280_FILTER_16 ||
+        c->standby > BME280_STANDBY_20) return 1;
 
+    cfg = *c;
+    return BME280_write_config();
+}
 
+/* ------------------------------------------------------------
+   BME280_get_config()
+   Copia la configurazione corrente
+------------------------------------------------------------ */
+void BME280_get_config(BME280_config_t *c) {
+    *c = cfg;
+}
+
+/* ------------------------------------------------------------
+   BME280_apply_profile()
+   Applica uno dei profili predefiniti
+   Ritorna 0 in caso di successo, 1 se il profilo non esiste
+------------------------------------------------------------ */
+uint8_t BME280_apply_profile(uint8_t profile) {
+    if (profile >= BME280_PROFILE_COUNT) return 1;
+
+    BME280_config_t c;
+    memcpy_P(&c, &profiles[profile], sizeof(c));
+    return BME280_configure(&c);
+}
+
+/* ------------------------------------------------------------
+   BME280_set_mode()
+   BME280_MODE_NORMAL: conversioni continue intervallate da t_sb
+   BME280_MODE_FORCED: una conversione per ogni BME280_trigger(),
+                       poi il sensore torna in sleep
+------------------------------------------------------------ */
+uint8_t BME280_set_mode(uint8_t m) {
+    if (m != BME280_MODE_NORMAL && m != BME280_MODE_FORCED) return 1;
+    mode = m;
+    return BME280_write_config();
+}
+
+/* ------------------------------------------------------------
+   BME280_trigger()
+   Avvia una conversione in modalità forced. Il primo controllo
+   di stato avviene dopo la durata massima della conversione.
+   Ritorna 0 in caso di successo, 1 se non in modalità forced
+------------------------------------------------------------ */
+uint8_t BME280_trigger(void) {
+    if (mode != BME280_MODE_FORCED) return 1;
+
+    uint8_t st = I2C_write_reg(BME280_ADDR, 0xF4, (cfg.osrs_t << 5) | (cfg.osrs_p << 2) | 0x01);
+    if (st) return st;
+
+    seen_measuring = 1;   // la fine della conversione va attesa anche se non osservata
+    next_poll_ms = due_ms = TIMER_millis() + meas_ms;
+    return 0;
+}
+
+/* ------------------------------------------------------------
+   BME280_set_sampling()
+   Imposta il tempo di standby (sampling rate interno)
+   secondo il valore scelto dall'utente in millisecondi.
+   Oversampling e filtro restano invariati.
+------------------------------------------------------------ */
+void BME280_set_sampling(uint16_t ms) {
+    if (ms == 125)       cfg.standby = BME280_STANDBY_125;
+    else if (ms == 250)  cfg.standby = BME280_STANDBY_250;
+    else if (ms == 500)  cfg.standby = BME280_STANDBY_500;
+    else                 cfg.standby = BME280_STANDBY_1000;
+
+    BME280_write_config();
+}
+
+/* ------------------------------------------------------------
+   BME280_measure_time_us()
+   Durata massima di una conversione (datasheet, par. 9.1):
+   t_meas = 1.25 + 2.3·osrs_t + (2.3·osrs_p + 0.575)
+            + (2.3·osrs_h + 0.575)   [ms]
+   Le grandezze con oversampling 0 (skip) non contribuiscono
+------------------------------------------------------------ */
+static uint8_t BME280_os_factor(uint8_t code) {
+    return code ? (1 << (code - 1)) : 0;   // 0, 1, 2, 4, 8, 16
+}
+
+uint32_t BME280_measure_time_us(void) {
+    uint8_t t = BME280_os_factor(cfg.osrs_t);
+    uint8_t p = BME280_os_factor(cfg.osrs_p);
+    uint8_t h = BME280_os_factor(cfg.osrs_h);
+    uint32_t us = 1250;
+    if (t) us += 2300UL * t;
+    if (p) us += 2300UL * p + 575;
+    if (h) us += 2300UL * h + 575;
+    return us;
+}
+
+/* ------------------------------------------------------------
+   BME280_output_rate_mhz()
+   Frequenza di uscita in modalità normale (mHz):
+   ODR = 1 / (t_meas + t_standby)
+------------------------------------------------------------ */
+uint32_t BME280_output_rate_mhz(void) {
+    return 1000000000UL / (BME280_measure_time_us() + BME280_standby_us());
+}
+
+/* ------------------------------------------------------------
+   BME280_data_ready()
+   Ritorna 1 se è disponibile una conversione non ancora letta.
+   Fino a poco prima della fine prevista della prossima
+   conversione non esegue traffico I2C; poi interroga 0xF3 e
+   riconosce la fine della conversione dal fronte di discesa
+   del bit "measuring". Se dal controllo precedente è passato
+   più di t_meas (più di un periodo, se ora la successiva è già
+   in corso) il fronte può essere sfuggito: superato due_ms la
+   conversione è comunque considerata nuova (il sensore
+   aggiorna i dati solo a fine conversione). Con controlli
+   ravvicinati serve sempre il fronte, così un sensore un po'
+   più lento del previsto non fa rileggere dati vecchi.
+   La fine sicura avanza poi di un periodo di conversione (di
+   t_meas se la successiva è già in corso).
+   Richiede TIMER_init().
+   In modalità forced interroga solo dopo BME280_trigger().
+------------------------------------------------------------ */
+uint8_t BME280_data_ready(void) {
+    if (data_pending) return 1;
+    if (mode == BME280_MODE_FORCED && !seen_measuring) return 0;   // nessuna conversione avviata
+
+    uint32_t now = TIMER_millis();
+    if ((int32_t)(now - next_poll_ms) < 0) return 0;
+
+    uint8_t status;
+    if (I2C_read_reg(BME280_ADDR, 0xF3, &status)) return 0;
+
+    uint32_t gap = now - last_poll_ms;
+    last_poll_ms = now;
+    next_poll_ms = now + 1;
+    uint8_t measuring = status & BME280_STATUS_MEASURING;
+    uint8_t missed = mode == BME280_MODE_NORMAL && (int32_t)(now - due_ms) >= 0 &&
+                     gap > (measuring ? period_ms : meas_ms);
+    if (!missed) {
+        if (measuring) {                      // conversione in corso
+            seen_measuring = 1;
+            return 0;
+        }
+        if (!seen_measuring) return 0;        // ancora in standby
+    }
+
+    // Conversione terminata: fronte di discesa osservato o fine
+    // sicura superata durante un'attesa più lunga di t_meas
+    data_pending = 1;
+    sample_seq++;
+    seen_measuring = measuring;
+    if (measuring) {                          // la successiva è già in corso
+        due_ms = now + meas_ms;
+    } else {                                  // la prossima inizia dopo t_standby
+        due_ms = now + period_ms;
+        if (standby_ms > 1) next_poll_ms = now + standby_ms - 1;
+    }
+    return 1;
+}
+
+/* ------------------------------------------------------------
+   BME280_sequence()
+   Numero di conversioni rilevate da BME280_data_ready():
+   cambia solo quando è disponibile un campione nuovo
+------------------------------------------------------------ */
+uint16_t BME280_sequence(void) {
+    return sample_seq;
+}
+
+/* ------------------------------------------------------------
+   BME280_read_temperature()
+   Legge la temperatura compensata in °C
+   - Usa le formule Bosch originali con i coefficienti letti
+   - Aggiorna la variabile t_fine (usata anche per P e H)
+------------------------------------------------------------ */
+float BME280_read_temperature(void) {
+    return BME280_compensate_temperature(BME280_read_raw_temp());
+}
+
+/* ------------------------------------------------------------
+   BME280_read_pressure()
+   Legge la pressione compensata in hPa
+   - Richiede t_fine calcolato in precedenza
+   - Esegue la formula di compensazione intera a 64 bit
+------------------------------------------------------------ */
+float BME280_read_pressure(void) {
+    return BME280_compensate_pressure(BME280_read_raw_press());
+}
+
+/* ------------------------------------------------------------
+   BME280_read_humidity()
+   Legge l’umidità relativa compensata in %RH
+   - Richiede t_fine calcolato dalla temperatura
+   - Applica compensazione secondo datasheet Bosch
+------------------------------------------------------------ */
+float BME280_read_humidity(void) {
+    return BME280_compensate_humidity(BME280_read_raw_hum());
+}
+
+/* ------------------------------------------------------------
+   BME280_read_raw()
+   Legge i dati grezzi 0xF7..0xFE in un'unica lettura burst
+   (8 byte: press[3], temp[3], hum[2])
+   Ritorna 0 in caso di successo, codice di errore I2C altrimenti
+------------------------------------------------------------ */
+uint8_t BME280_read_raw(BME280_raw_t *raw) {
+    uint8_t buf[8];
+    uint8_t st = I2C_read_regs(BME280_ADDR, 0xF7, buf, sizeof(buf));
+    if (st) return st;
+
+    raw->adc_P = ((int32_t)buf[0] << 12) | ((int32_t)buf[1] << 4) | (buf[2] >> 4);
+    raw->adc_T = ((int32_t)buf[3] << 12) | ((int32_t)buf[4] << 4) | (buf[5] >> 4);
+    raw->adc_H = ((int32_t)buf[6] << 8)  | buf[7];
+    data_pending = 0;
+    return 0;
+}
+
+/* ------------------------------------------------------------
+   BME280_compensate() / BME280_compensate_fixed()
+   Compensano uno snapshot grezzo in float o in virgola fissa.
+   La temperatura è calcolata per prima perché aggiorna t_fine.
+------------------------------------------------------------ */
+void BME280_compensate(const BME280_raw_t *raw, BME280_data_t *out) {
+    out->temperature = BME280_compensate_temperature(raw->adc_T);
+    out->pressure    = BME280_compensate_pressure(raw->adc_P);
+    out->humidity    = BME280_compensate_humidity(raw->adc_H);
+}
+
+void BME280_compensate_fixed(const BME280_raw_t *raw, BME280_fixed_t *out) {
+    out->temperature = (int16_t)BME280_compensate_temperature_int(raw->adc_T);
+    out->pressure    = BME280_compensate_pressure_int(raw->adc_P);
+    out->humidity    = BME280_compensate_humidity_int(raw->adc_H);
+}
+
+/* ------------------------------------------------------------
+   BME280_read_all() / BME280_read_all_fixed()
+   Lettura burst + compensazione dallo stesso snapshot:
+   i tre valori appartengono sempre alla stessa conversione.
+   Ritorna 0 in caso di successo, codice di errore I2C altrimenti
+------------------------------------------------------------ */
+uint8_t BME280_read_all(BME280_data_t *out) {
+    BME280_raw_t raw;
+    uint8_t st = BME280_read_raw(&raw);
+    if (st) return st;
+    BME280_compensate(&raw, out);
+    return 0;
+}
+
+uint8_t BME280_read_all_fixed(BME280_fixed_t *out) {
+    BME280_raw_t raw;
+    uint8_t st = BME280_read_raw(&raw);
+    if (st) return st;
+    BME280_compensate_fixed(&raw, out);
+    return 0;
+}
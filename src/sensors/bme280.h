@@ -7,6 +7,88 @@
 ------------------------------------------------------------ */
 #define BME280_ADDR 0x76
 
+/* ------------------------------------------------------------
+   Snapshot coerente di una singola conversione
+------------------------------------------------------------ */
+typedef struct {
+    float temperature;   // °C
+    float pressure;      // hPa
+    float humidity;      // %RH
+} BME280_data_t;
+
+/* ------------------------------------------------------------
+   Snapshot in virgola fissa (nessun float né int64)
+------------------------------------------------------------ */
+typedef struct {
+    int16_t  temperature;   // centesimi di °C (2345 = 23.45 °C)
+    uint32_t pressure;      // Pa
+    uint32_t humidity;      // %RH in Q22.10 (47445 = 46.333 %RH)
+} BME280_fixed_t;
+
+/* ------------------------------------------------------------
+   Valori ADC grezzi di una conversione
+------------------------------------------------------------ */
+typedef struct {
+    int32_t adc_T;
+    int32_t adc_P;
+    int32_t adc_H;
+} BME280_raw_t;
+
+/* ------------------------------------------------------------
+   Codici di configurazione (valori dei campi nei registri)
+------------------------------------------------------------ */
+typedef enum {               // osrs_t / osrs_p / osrs_h
+    BME280_OS_SKIP = 0,
+    BME280_OS_X1   = 1,
+    BME280_OS_X2   = 2,
+    BME280_OS_X4   = 3,
+    BME280_OS_X8   = 4,
+    BME280_OS_X16  = 5
+} BME280_oversampling_t;
+
+typedef enum {               // coefficiente del filtro IIR
+    BME280_FILTER_OFF = 0,
+    BME280_FILTER_2   = 1,
+    BME280_FILTER_4   = 2,
+    BME280_FILTER_8   = 3,
+    BME280_FILTER_16  = 4
+} BME280_filter_t;
+
+typedef enum {               // t_sb in modalità normale
+    BME280_STANDBY_0_5  = 0,
+    BME280_STANDBY_62_5 = 1,
+    BME280_STANDBY_125  = 2,
+    BME280_STANDBY_250  = 3,
+    BME280_STANDBY_500  = 4,
+    BME280_STANDBY_1000 = 5,
+    BME280_STANDBY_10   = 6,
+    BME280_STANDBY_20   = 7
+} BME280_standby_t;
+
+typedef struct {
+    uint8_t osrs_t;   // BME280_oversampling_t
+    uint8_t osrs_p;
+    uint8_t osrs_h;
+    uint8_t filter;   // BME280_filter_t
+    uint8_t standby;  // BME280_standby_t
+} BME280_config_t;
+
+typedef enum {
+    BME280_MODE_NORMAL = 0,  // conversioni continue (t_meas + t_sb)
+    BME280_MODE_FORCED = 1   // una conversione su richiesta, poi sleep
+} BME280_mode_t;
+
+/* ------------------------------------------------------------
+   Profili predefiniti
+------------------------------------------------------------ */
+typedef enum {
+    BME280_PROFILE_LOW_LATENCY = 0,
+    BME280_PROFILE_BALANCED    = 1,
+    BME280_PROFILE_LOW_NOISE   = 2,
+    BME280_PROFILE_WEATHER     = 3,
+    BME280_PROFILE_COUNT
+} BME280_profile_t;
+
 /* ------------------------------------------------------------
    BME280_init()
    Inizializza il sensore:
@@ -16,10 +98,51 @@
 void BME280_init(void);
 
 /* ------------------------------------------------------------
-   Imposta il tempo di standby (sampling rate interno)
+   Cache dei coefficienti di calibrazione
+   - BME280_get_calibration(): copia i BME280_CALIB_LEN byte
+     letti dal sensore (1 se non disponibili)
+   - BME280_init_cached(): inizializza il sensore senza
+     rileggere la calibrazione; 0 se la copia corrisponde al
+     sensore collegato, altrimenti serve BME280_init()
+------------------------------------------------------------ */
+#define BME280_CALIB_LEN 33
+
+uint8_t BME280_get_calibration(uint8_t *calib);
+uint8_t BME280_init_cached(const uint8_t *calib);
+
+/* ------------------------------------------------------------
+   Imposta il tempo di standby (sampling rate interno),
+   sostituendo quello del profilo applicato
 ------------------------------------------------------------ */
 void BME280_set_sampling(uint16_t ms);
 
+/* ------------------------------------------------------------
+   Configurazione a runtime di oversampling, filtro e standby
+   BME280_configure() / BME280_apply_profile() ritornano 0 in
+   caso di successo, 1 se i parametri non sono validi
+------------------------------------------------------------ */
+uint8_t  BME280_configure(const BME280_config_t *cfg);
+void     BME280_get_config(BME280_config_t *cfg);
+uint8_t  BME280_apply_profile(uint8_t profile);
+
+// Modalità di funzionamento e avvio di una conversione forced
+uint8_t  BME280_set_mode(uint8_t mode);
+uint8_t  BME280_trigger(void);
+
+// Frequenza di uscita risultante in modalità normale (mHz)
+uint32_t BME280_output_rate_mhz(void);
+
+/* ------------------------------------------------------------
+   Rilevamento di nuove conversioni
+   - BME280_data_ready(): 1 se c'è una conversione non ancora
+     letta (la lettura con BME280_read_* la consuma)
+   - BME280_sequence(): contatore delle conversioni rilevate
+   - BME280_measure_time_us(): durata massima di una conversione
+------------------------------------------------------------ */
+uint8_t  BME280_data_ready(void);
+uint16_t BME280_sequence(void);
+uint32_t BME280_measure_time_us(void);
+
 /* ------------------------------------------------------------
    Letture dei parametri ambientali 
    Restituiscono valori già compensati tramite formule Bosch.
@@ -32,6 +155,23 @@ float BME280_read_temperature(void);
 float BME280_read_pressure(void);
 float BME280_read_humidity(void);
 
+/* ------------------------------------------------------------
+   Legge temperatura, pressione e umidità con un'unica lettura
+   burst (0xF7..0xFE) e le compensa dallo stesso snapshot.
+   Ritorna 0 in caso di successo, codice di errore I2C altrimenti
+------------------------------------------------------------ */
+uint8_t BME280_read_all(BME280_data_t *out);
+
+// Come BME280_read_all(), in virgola fissa (variante Bosch a 32 bit)
+uint8_t BME280_read_all_fixed(BME280_fixed_t *out);
+
+/* ------------------------------------------------------------
+   Lettura grezza e compensazione separate
+------------------------------------------------------------ */
+uint8_t BME280_read_raw(BME280_raw_t *raw);
+void    BME280_compensate(const BME280_raw_t *raw, BME280_data_t *out);
+void    BME280_compensate_fixed(const BME280_raw_t *raw, BME280_fixed_t *out);
+
 
 
 
@@ -0,0 +1,152 @@
+#include <string.h>
+
+#include "stats.h"
+
+/* ------------------------------------------------------------
+   Accumulatore: somme degli scarti d = x - ref, dove ref è il
+   primo campione dell'accumulatore (del blocco o della sessione
+   dopo STATS_reset()), così gli scarti restano piccoli anche
+   se il canale deriva.
+   |d| è limitato a STATS_MAX_DEV così d² sta in 32 bit
+   (463 °C, 463 hPa, 463 %RH: oltre i limiti fisici del sensore)
+------------------------------------------------------------ */
+#define STATS_MAX_DEV 46340L
+
+typedef struct {
+    uint32_t n;
+    int32_t  ref;
+    int32_t  min, max;
+    int64_t  sum;     // Σd   (solo somme: nessuna moltiplicazione a 64 bit)
+    uint64_t sumsq;   // Σd²
+} STATS_acc_t;
+
+static STATS_acc_t session[STATS_CH_COUNT];
+static uint32_t    session_start_ms = 0;
+
+static STATS_acc_t blocks[STATS_SLIDE_BLOCKS + 1][STATS_CH_COUNT];
+static uint32_t    block_id[STATS_SLIDE_BLOCKS + 1];   // now_s / STATS_BLOCK_S
+static uint8_t     block_cur = 0;
+
+static void STATS_acc_add(STATS_acc_t *a, int32_t x) {
+    if (a->n == 0) a->ref = a->min = a->max = x;
+    if (x < a->min) a->min = x;
+    if (x > a->max) a->max = x;
+
+    int32_t d = x - a->ref;
+    if (d > STATS_MAX_DEV) d = STATS_MAX_DEV;
+    else if (d < -STATS_MAX_DEV) d = -STATS_MAX_DEV;
+    a->n++;
+    a->sum += d;
+    a->sumsq += (uint32_t)(d * d);
+}
+
+/* ------------------------------------------------------------
+   STATS_acc_shift()
+   Riferisce le somme a un nuovo riferimento r (solo in lettura):
+   con k = ref - r, Σ(d + k) = Σd + n·k e
+   Σ(d + k)² = Σd² + 2k·Σd + n·k²  (esatto in 64 bit)
+------------------------------------------------------------ */
+static void STATS_acc_shift(STATS_acc_t *a, int32_t r) {
+    int64_t k = (int64_t)a->ref - r;
+    a->sumsq = (uint64_t)((int64_t)a->sumsq + 2 * k * a->sum + (int64_t)a->n * k * k);
+    a->sum  += (int64_t)a->n * k;
+    a->ref   = r;
+}
+
+static void STATS_acc_merge(STATS_acc_t *dst, const STATS_acc_t *src) {
+    if (!src->n) return;
+    if (!dst->n) {
+        *dst = *src;
+        return;
+    }
+    STATS_acc_t s = *src;
+    STATS_acc_shift(&s, dst->ref);
+    if (s.min < dst->min) dst->min = s.min;
+    if (s.max > dst->max) dst->max = s.max;
+    dst->n += s.n;
+    dst->sum += s.sum;
+    dst->sumsq += s.sumsq;
+}
+
+/* ------------------------------------------------------------
+   STATS_add()
+------------------------------------------------------------ */
+void STATS_add(uint32_t ms, int32_t temp, int32_t press, int32_t hum) {
+    const int32_t x[STATS_CH_COUNT] = { temp, press, hum };
+
+    // Nuovo blocco della finestra scorrevole: riusa il più vecchio
+    uint32_t id = ms / 1000 / STATS_BLOCK_S;
+    if (block_id[block_cur] != id) {
+        if (++block_cur > STATS_SLIDE_BLOCKS) block_cur = 0;
+        block_id[block_cur] = id;
+        memset(blocks[block_cur], 0, sizeof(blocks[block_cur]));
+    }
+
+    for (uint8_t c = 0; c < STATS_CH_COUNT; c++) {
+        STATS_acc_add(&session[c], x[c]);
+        STATS_acc_add(&blocks[block_cur][c], x[c]);
+    }
+}
+
+/* ------------------------------------------------------------
+   Radice quadrata intera (per eccesso/difetto al più vicino)
+------------------------------------------------------------ */
+static uint32_t isqrt64(uint64_t v) {
+    uint64_t r = 0, bit = (uint64_t)1 << 62;
+    while (bit > v) bit >>= 2;
+    while (bit) {
+        if (v >= r + bit) { v -= r + bit; r = (r >> 1) + bit; }
+        else r >>= 1;
+        bit >>= 2;
+    }
+    if (v > r) r++;   // arrotonda
+    return (uint32_t)r;
+}
+
+/* ------------------------------------------------------------
+   STATS_get()
+   Le somme vengono riferite alla media arrotondata c, così
+   |Σd| <= n/2 e la cancellazione in Σd² - (Σd)²/n è esatta:
+   media    = c + Σd / n
+   varianza = (Σd² - (Σd)² / n) / n   (calcolata in Q8)
+------------------------------------------------------------ */
+uint8_t STATS_get(uint8_t window, uint8_t ch, STATS_summary_t *out) {
+    STATS_acc_t a;
+    if (ch >= STATS_CH_COUNT) return 1;
+
+    if (window == STATS_WIN_SESSION) {
+        a = session[ch];
+    } else {
+        memset(&a, 0, sizeof(a));
+        uint32_t now = block_id[block_cur];
+        for (uint8_t b = 0; b <= STATS_SLIDE_BLOCKS; b++)
+            if (now - block_id[b] <= STATS_SLIDE_BLOCKS)
+                STATS_acc_merge(&a, &blocks[b][ch]);
+    }
+    if (!a.n) return 1;
+
+    int64_t n = a.n;
+    STATS_acc_shift(&a, a.ref + (int32_t)((a.sum + (a.sum < 0 ? -n / 2 : n / 2)) / n));
+    int64_t sq_q8  = (a.sum * a.sum * 256 + n / 2) / n;   // (Σd)²/n, Σd <= n/2
+    int64_t var_q8 = ((int64_t)a.sumsq * 256 - sq_q8 + n / 2) / n;
+    if (var_q8 < 0) var_q8 = 0;
+
+    out->n      = a.n;
+    out->min    = a.min;
+    out->max    = a.max;
+    out->mean   = a.ref + (int32_t)((2 * a.sum + (a.sum < 0 ? -n : n)) / (2 * n));
+    out->stddev = (isqrt64((uint64_t)var_q8) + 8) / 16;
+    return 0;
+}
+
+/* ------------------------------------------------------------
+   STATS_reset() / STATS_session_start_ms()
+------------------------------------------------------------ */
+void STATS_reset(uint32_t ms) {
+    memset(session, 0, sizeof(session));
+    session_start_ms = ms;
+}
+
+uint32_t STATS_session_start_ms(void) {
+    return session_start_ms;
+}
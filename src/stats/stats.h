@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdint.h>
+
+/* ------------------------------------------------------------
+   Statistiche incrementali per canale (min, max, media,
+   deviazione standard, numero di campioni), su due finestre:
+   - STATS_WIN_SESSION: dall'avvio o dall'ultimo STATS_reset()
+   - STATS_WIN_SLIDING: ultimi STATS_SLIDE_BLOCKS blocchi da
+     STATS_BLOCK_S secondi (più il blocco in corso)
+   Aggiornamento O(1) per campione, solo somme intere: le somme
+   degli scarti dal primo campione di ogni blocco (o della
+   sessione) sono esatte, quindi non serve la divisione per
+   campione dell'algoritmo di Welford. Media e varianza sono
+   calcolate solo alla lettura (STATS_get()), riferendo le
+   somme alla media: il risultato non dipende dalla deriva.
+------------------------------------------------------------ */
+#ifndef STATS_BLOCK_S
+#define STATS_BLOCK_S      60
+#endif
+#ifndef STATS_SLIDE_BLOCKS
+#define STATS_SLIDE_BLOCKS 10   // finestra scorrevole di 10 minuti
+#endif
+
+typedef enum {
+    STATS_CH_TEMP  = 0,   // centesimi di °C
+    STATS_CH_PRESS = 1,   // Pa
+    STATS_CH_HUM   = 2,   // centesimi di %RH
+    STATS_CH_COUNT
+} STATS_channel_t;
+
+typedef enum {
+    STATS_WIN_SESSION = 0,
+    STATS_WIN_SLIDING = 1
+} STATS_window_t;
+
+/* ------------------------------------------------------------
+   Riepilogo di un canale (stesse unità del canale)
+------------------------------------------------------------ */
+typedef struct {
+    uint32_t n;
+    int32_t  min, max;
+    int32_t  mean;     // arrotondata
+    uint32_t stddev;   // deviazione standard della popolazione, arrotondata
+} STATS_summary_t;
+
+/* ------------------------------------------------------------
+   API
+   - STATS_add(): un campione per tutti i canali (t in ms)
+   - STATS_get(): 0 se la finestra contiene campioni, 1 altrimenti
+   - STATS_reset(): azzera la finestra di sessione
+   - STATS_session_start_ms(): inizio della finestra di sessione
+------------------------------------------------------------ */
+void     STATS_add(uint32_t ms, int32_t temp, int32_t press, int32_t hum);
+uint8_t  STATS_get(uint8_t window, uint8_t ch, STATS_summary_t *out);
+void     STATS_reset(uint32_t ms);
+uint32_t STATS_session_start_ms(void);
@@ -0,0 +1,57 @@
+#include <avr/eeprom.h>
+#include <util/crc16.h>
+
+#include "storage.h"
+
+/* ------------------------------------------------------------
+   Calcola il CRC-16 CCITT di intestazione e dati
+------------------------------------------------------------ */
+static uint16_t STORAGE_crc(uint8_t id, const uint8_t *data, uint8_t len) {
+    uint16_t crc = 0xFFFF;
+    crc = _crc_ccitt_update(crc, id);
+    crc = _crc_ccitt_update(crc, len);
+    for (uint8_t i = 0; i < len; i++)
+        crc = _crc_ccitt_update(crc, data[i]);
+    return crc;
+}
+
+/* ------------------------------------------------------------
+   STORAGE_load()
+   Legge un record e ne verifica id, lunghezza e CRC
+------------------------------------------------------------ */
+uint8_t STORAGE_load(uint16_t addr, uint8_t id, void *data, uint8_t len) {
+    uint8_t *p = (uint8_t *)(uintptr_t)addr;
+    uint8_t crc[2];
+
+    if (eeprom_read_byte(p) != id || eeprom_read_byte(p + 1) != len) return 1;
+
+    eeprom_read_block(data, p + 2, len);
+    eeprom_read_block(crc, p + 2 + len, 2);
+
+    uint16_t expected = STORAGE_crc(id, data, len);
+    return (crc[0] == (uint8_t)expected && crc[1] == (uint8_t)(expected >> 8)) ? 0 : 1;
+}
+
+/* ------------------------------------------------------------
+   STORAGE_save()
+   Scrive un record; eeprom_update_* riscrive solo le celle
+   cambiate, quindi salvare dati invariati non consuma cicli
+------------------------------------------------------------ */
+void STORAGE_save(uint16_t addr, uint8_t id, const void *data, uint8_t len) {
+    uint8_t *p = (uint8_t *)(uintptr_t)addr;
+    uint16_t c = STORAGE_crc(id, data, len);
+    uint8_t crc[2] = { (uint8_t)c, (uint8_t)(c >> 8) };
+
+    eeprom_update_byte(p, 0xFF);   // record non valido durante la scrittura
+    eeprom_update_byte(p + 1, len);
+    eeprom_update_block(data, p + 2, len);
+    eeprom_update_block(crc, p + 2 + len, 2);
+    eeprom_update_byte(p, id);     // id per ultimo: un'interruzione lascia il record invalido
+}
+
+/* ------------------------------------------------------------
+   STORAGE_erase()
+------------------------------------------------------------ */
+void STORAGE_erase(uint16_t addr) {
+    eeprom_update_byte((uint8_t *)(uintptr_t)addr, 0xFF);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stdint.h>
+
+/* ------------------------------------------------------------
+   Record persistenti in EEPROM
+   Formato: [id][len][dati ... len byte][CRC-16 CCITT lo/hi]
+   Il CRC copre id, len e dati; un record con id, lunghezza o
+   CRC diversi da quelli attesi è considerato assente
+------------------------------------------------------------ */
+#define STORAGE_OVERHEAD 4   // id + len + CRC
+
+/* ------------------------------------------------------------
+   Mappa della EEPROM (indirizzi dei record)
+------------------------------------------------------------ */
+#define STORAGE_ADDR_CONFIG 0x000
+#define STORAGE_ADDR_CALIB  0x040
+#define STORAGE_ADDR_EVENTS 0x080
+
+/* ------------------------------------------------------------
+   Identificativi dei record: cambiarli quando cambia il
+   formato dei dati invalida i record già scritti
+------------------------------------------------------------ */
+#define STORAGE_ID_CONFIG 0xC2
+#define STORAGE_ID_CALIB  0xB1
+#define STORAGE_ID_EVENTS 0xE1
+
+/* ------------------------------------------------------------
+   API EEPROM
+   - STORAGE_load(): 0 se il record è valido (dati copiati in
+     data), 1 altrimenti (il contenuto di data non è definito)
+   - STORAGE_save(): scrive solo i byte cambiati
+   - STORAGE_erase(): invalida il record
+------------------------------------------------------------ */
+uint8_t STORAGE_load(uint16_t addr, uint8_t id, void *data, uint8_t len);
+void    STORAGE_save(uint16_t addr, uint8_t id, const void *data, uint8_t len);
+void    STORAGE_erase(uint16_t addr);
@@ -0,0 +1,129 @@
+#include <util/crc16.h>
+
+#include "../../avr_common/uart/uart.h"
+#include "telemetry.h"
+
+/* ------------------------------------------------------------
+   TELEM_cobs_encode()
+   Ogni blocco inizia con la distanza dal prossimo zero
+   (o dalla fine), poi i byte non nulli del blocco
+------------------------------------------------------------ */
+uint8_t TELEM_cobs_encode(const uint8_t *in, uint8_t len, uint8_t *out) {
+    uint8_t code_idx = 0;   // posizione del byte di lunghezza corrente
+    uint8_t code = 1;
+    uint8_t o = 1;
+
+    for (uint8_t i = 0; i < len; i++) {
+        if (in[i] == 0) {
+            out[code_idx] = code;
+            code_idx = o++;
+            code = 1;
+        } else {
+            out[o++] = in[i];
+            code++;
+        }
+    }
+    out[code_idx] = code;
+    return o;
+}
+
+static uint8_t *put16(uint8_t *p, uint16_t v) {
+    *p++ = (uint8_t)v;
+    *p++ = (uint8_t)(v >> 8);
+    return p;
+}
+
+static uint8_t *put32(uint8_t *p, uint32_t v) {
+    p = put16(p, (uint16_t)v);
+    return put16(p, (uint16_t)(v >> 16));
+}
+
+/* ------------------------------------------------------------
+   TELEM_send()
+   Aggiunge il CRC a len byte già scritti in pkt (che deve avere
+   2 byte liberi in coda), codifica e accoda il pacchetto.
+   Il pacchetto è accodato per intero o per niente: un pacchetto
+   troncato costerebbe banda e verrebbe comunque scartato dal CRC
+------------------------------------------------------------ */
+static uint8_t TELEM_send(uint8_t *pkt, uint8_t len) {
+    uint8_t frame[TELEM_FRAME_MAX];
+
+    uint16_t crc = 0xFFFF;
+    for (uint8_t i = 0; i < len; i++) crc = _crc_ccitt_update(crc, pkt[i]);
+    put16(pkt + len, crc);
+
+    frame[0] = 0x00;
+    uint8_t n = TELEM_cobs_encode(pkt, len + 2, frame + 1) + 1;
+    frame[n++] = 0x00;
+
+    if (UART_tx_free() < n) return 1;
+    UART_write(frame, n);
+    return 0;
+}
+
+/* ------------------------------------------------------------
+   TELEM_send_sample()
+------------------------------------------------------------ */
+static uint8_t TELEM_send_typed(uint8_t type, uint16_t seq, uint32_t ms,
+                                int16_t temp_centi, uint32_t press_pa, uint16_t hum_centi) {
+    uint8_t pkt[TELEM_SAMPLE_LEN];
+    uint8_t *p = pkt;
+
+    *p++ = type;
+    p = put16(p, seq);
+    p = put32(p, ms);
+    p = put16(p, (uint16_t)temp_centi);
+    p = put32(p, press_pa);
+    p = put16(p, hum_centi);
+    return TELEM_send(pkt, p - pkt);
+}
+
+uint8_t TELEM_send_sample(uint16_t seq, uint32_t ms,
+                          int16_t temp_centi, uint32_t press_pa, uint16_t hum_centi) {
+    return TELEM_send_typed(TELEM_TYPE_SAMPLE, seq, ms, temp_centi, press_pa, hum_centi);
+}
+
+/* ------------------------------------------------------------
+   TELEM_send_raw()
+------------------------------------------------------------ */
+uint8_t TELEM_send_raw(const HIST_sample_t *s) {
+    return TELEM_send_typed(TELEM_TYPE_RAW, s->seq, s->ms, s->temp, s->press, s->hum);
+}
+
+/* ------------------------------------------------------------
+   TELEM_send_bucket()
+------------------------------------------------------------ */
+uint8_t TELEM_send_bucket(uint8_t tier, const HIST_bucket_t *b) {
+    uint8_t pkt[TELEM_BUCKET_LEN];
+    uint8_t *p = pkt;
+
+    *p++ = TELEM_TYPE_BUCKET;
+    *p++ = tier;
+    p = put32(p, b->start_s);
+    p = put16(p, b->n);
+    p = put16(p, (uint16_t)b->t_min);
+    p = put16(p, (uint16_t)b->t_avg);
+    p = put16(p, (uint16_t)b->t_max);
+    p = put16(p, b->p_min);
+    p = put16(p, b->p_avg);
+    p = put16(p, b->p_max);
+    p = put16(p, b->h_min);
+    p = put16(p, b->h_avg);
+    p = put16(p, b->h_max);
+    return TELEM_send(pkt, p - pkt);
+}
+
+/* ------------------------------------------------------------
+   TELEM_send_event()
+------------------------------------------------------------ */
+uint8_t TELEM_send_event(uint8_t ch, uint8_t state, uint32_t ms, int32_t value) {
+    uint8_t pkt[TELEM_EVENT_LEN];
+    uint8_t *p = pkt;
+
+    *p++ = TELEM_TYPE_EVENT;
+    *p++ = ch;
+    *p++ = state;
+    p = put32(p, ms);
+    p = put32(p, (uint32_t)value);
+    return TELEM_send(pkt, p - pkt);
+}
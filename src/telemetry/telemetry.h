@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "../history/history.h"
+
+/* ------------------------------------------------------------
+   Telemetria binaria sulla UART
+   Ogni pacchetto è codificato COBS e delimitato da 0x00 prima
+   e dopo, così il client si risincronizza dopo testo o byte
+   persi. Tutti i campi sono little-endian e ogni pacchetto
+   termina con il CRC-16 CCITT (init 0xFFFF) dei byte precedenti.
+
+   Campione (TELEM_TYPE_SAMPLE dal vivo, TELEM_TYPE_RAW dallo
+   storico, stesso formato):
+     [0]      tipo (TELEM_TYPE_SAMPLE)
+     [1..2]   numero di sequenza (BME280_sequence() per lo storico,
+              vedi sotto per i campioni dal vivo)
+     [3..6]   timestamp in ms dall'avvio
+     [7..8]   temperatura, centesimi di °C (int16)
+     [9..12]  pressione, Pa (uint32)
+     [13..14] umidità, centesimi di %RH (uint16)
+     [15..16] CRC
+
+   Intervallo dello storico (TELEM_TYPE_BUCKET):
+     [0]      tipo
+     [1]      livello (HIST_TIER_1MIN / HIST_TIER_15MIN)
+     [2..5]   inizio, s dall'avvio
+     [6..7]   campioni aggregati
+     [8..13]  temperatura min/media/max, centesimi di °C (int16)
+     [14..19] pressione min/media/max, decimi di hPa (uint16)
+     [20..25] umidità min/media/max, centesimi di %RH (uint16)
+     [26..27] CRC
+
+   Evento di soglia (TELEM_TYPE_EVENT):
+     [0]      tipo
+     [1]      canale (EVT_CH_*)
+     [2]      nuovo stato (EVT_NORMAL / EVT_LOW / EVT_HIGH)
+     [3..6]   timestamp in ms dall'avvio
+     [7..10]  valore che ha causato il cambio (int32, unità del canale)
+     [11..12] CRC
+
+   Con il report-by-exception (src/events) i campioni dal vivo
+   non sono consecutivi: il loro numero di sequenza conta i
+   campioni riportati, quindi un salto indica solo perdite
+------------------------------------------------------------ */
+#define TELEM_TYPE_SAMPLE 0x01
+#define TELEM_TYPE_BUCKET 0x02
+#define TELEM_TYPE_RAW    0x03
+#define TELEM_TYPE_EVENT  0x04
+#define TELEM_SAMPLE_LEN  17                        // con CRC
+#define TELEM_BUCKET_LEN  28
+#define TELEM_EVENT_LEN   13
+#define TELEM_FRAME_MAX   (TELEM_BUCKET_LEN + 3)    // + COBS + 2 delimitatori
+
+/* ------------------------------------------------------------
+   TELEM_cobs_encode()
+   Codifica len byte (len < 254) senza zeri; ritorna la
+   lunghezza codificata (len + 1)
+------------------------------------------------------------ */
+uint8_t TELEM_cobs_encode(const uint8_t *in, uint8_t len, uint8_t *out);
+
+/* ------------------------------------------------------------
+   TELEM_send_sample()
+   Compone, codifica e accoda sulla UART un campione senza
+   attendere: ritorna 0 se accodato, 1 se scartato perché il
+   buffer TX non ha spazio per l'intero pacchetto
+------------------------------------------------------------ */
+uint8_t TELEM_send_sample(uint16_t seq, uint32_t ms,
+                          int16_t temp_centi, uint32_t press_pa, uint16_t hum_centi);
+
+/* ------------------------------------------------------------
+   TELEM_send_bucket()
+   Come TELEM_send_sample(), per un elemento dello storico
+------------------------------------------------------------ */
+uint8_t TELEM_send_bucket(uint8_t tier, const HIST_bucket_t *b);
+uint8_t TELEM_send_raw(const HIST_sample_t *s);
+
+/* ------------------------------------------------------------
+   TELEM_send_event()
+   Cambio di stato di una soglia (stesso esito di TELEM_send_sample())
+------------------------------------------------------------ */
+uint8_t TELEM_send_event(uint8_t ch, uint8_t state, uint32_t ms, int32_t value);
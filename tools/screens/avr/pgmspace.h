@@ -0,0 +1,8 @@
+#pragma once
+
+/* ------------------------------------------------------------
+   Sostituto minimo di <avr/pgmspace.h> per compilare il font
+   del firmware sul PC: i dati in "flash" sono normali costanti
+------------------------------------------------------------ */
+#define PROGMEM
+#define pgm_read_byte(p) (*(const unsigned char *)(p))
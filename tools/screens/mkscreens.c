@@ -0,0 +1,140 @@
+#include <stdio.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "../../src/display/font/font.h"
+
+/* ------------------------------------------------------------
+   mkscreens
+   Pre-renderizza con il font 5x7 del firmware le righe statiche
+   dell'interfaccia (menù, benvenuto, uscita) e genera il sorgente
+   C con le bitmap in PROGMEM, da disegnare con OLED_blit_P().
+   Uso: mkscreens <screens.c> <screens.h>
+------------------------------------------------------------ */
+#define COLS 128
+
+typedef struct {
+    const char *name;   // nome C della bitmap (SCREENS_<name>)
+    const char *text;
+} row_t;
+
+static const row_t rows[] = {
+    { "menu_title", "SELECT PARAMETER:" },
+    { "welcome",    "       WELCOME!" },
+    { "goodbye",    "     GOODBYE! :)" },
+};
+
+// Voci del menù, nello stesso ordine di MENU_* in proxy.c
+static const char *menu_items[] = {
+    "Temperature", "Pressure", "Humidity", "All", "Stats", "Graph", "Exit"
+};
+#define MENU_ITEMS (int)(sizeof(menu_items) / sizeof(menu_items[0]))
+
+/* ------------------------------------------------------------
+   render()
+   Come OLED_render_line(): 5 colonne di glifo + 1 vuota per
+   carattere. Ritorna la larghezza senza le colonne vuote finali
+------------------------------------------------------------ */
+static int render(const char *text, unsigned char *out) {
+    int col = 0, width = 0;
+
+    memset(out, 0, COLS);
+    for (; *text && col + 6 <= COLS; text++) {
+        char c = *text;
+        if (c < 32 || c > 126) c = '?';
+        for (int i = 0; i < 5; i++) out[col++] = OLED_font5x7[(c - 32) * 5 + i];
+        out[col++] = 0x00;
+    }
+    for (int i = 0; i < col; i++)
+        if (out[i]) width = i + 1;
+    return width;
+}
+
+static void emit_bytes(FILE *f, const unsigned char *b, int n, const char *indent) {
+    for (int i = 0; i < n; i++) {
+        if (i % 16 == 0) fprintf(f, "%s", indent);
+        fprintf(f, "0x%02X,%s", b[i], (i % 16 == 15 || i == n - 1) ? "\n" : "");
+    }
+}
+
+static void upper(char *dst, const char *src) {
+    while (*src) *dst++ = toupper((unsigned char)*src++);
+    *dst = '\0';
+}
+
+int main(int argc, char **argv) {
+    if (argc != 3) {
+        fprintf(stderr, "Usage: mkscreens <screens.c> <screens.h>\n");
+        return 1;
+    }
+
+    FILE *c = fopen(argv[1], "w");
+    FILE *h = fopen(argv[2], "w");
+    if (!c || !h) {
+        perror("fopen");
+        return 1;
+    }
+
+    static const char banner[] =
+        "/* ------------------------------------------------------------\n"
+        "   File generato da tools/screens/mkscreens: non modificare\n"
+        "------------------------------------------------------------ */\n";
+
+    fprintf(h, "#pragma once\n\n%s\n#include <stdint.h>\n#include <avr/pgmspace.h>\n\n", banner);
+    fprintf(h, "/* ------------------------------------------------------------\n"
+               "   Righe statiche pre-renderizzate con il font 5x7\n"
+               "   Una pagina del display (8 pixel) per riga, un byte per\n"
+               "   colonna; le colonne oltre la larghezza sono vuote.\n"
+               "   Disegnare con OLED_blit_P(line, bitmap, larghezza)\n"
+               "------------------------------------------------------------ */\n");
+    fprintf(c, "%s\n#include \"screens.h\"\n", banner);
+
+    unsigned char bmp[COLS];
+    char name[32];
+
+    for (size_t r = 0; r < sizeof(rows) / sizeof(rows[0]); r++) {
+        int w = render(rows[r].text, bmp);
+        upper(name, rows[r].name);
+        fprintf(h, "#define SCREENS_%s_W %d\n", name, w);
+        fprintf(h, "extern const uint8_t SCREENS_%s[SCREENS_%s_W] PROGMEM;   // \"%s\"\n\n",
+                rows[r].name, name, rows[r].text);
+
+        fprintf(c, "\n// \"%s\"\n", rows[r].text);
+        fprintf(c, "const uint8_t SCREENS_%s[SCREENS_%s_W] PROGMEM = {\n", rows[r].name, name);
+        emit_bytes(c, bmp, w, "    ");
+        fprintf(c, "};\n");
+    }
+
+    // Voci del menù: "    voce" e "--> voce", larghezza comune
+    unsigned char menu[MENU_ITEMS][2][COLS];
+    int menu_w = 0;
+    for (int i = 0; i < MENU_ITEMS; i++) {
+        for (int sel = 0; sel < 2; sel++) {
+            char text[32];
+            snprintf(text, sizeof(text), "%s%s", sel ? "--> " : "    ", menu_items[i]);
+            int w = render(text, menu[i][sel]);
+            if (w > menu_w) menu_w = w;
+        }
+    }
+
+    fprintf(h, "// Voci del menù: [voce][1 = selezionata]\n");
+    fprintf(h, "#define SCREENS_MENU_ITEMS %d\n", MENU_ITEMS);
+    fprintf(h, "#define SCREENS_MENU_W %d\n", menu_w);
+    fprintf(h, "extern const uint8_t SCREENS_menu[SCREENS_MENU_ITEMS][2][SCREENS_MENU_W] PROGMEM;\n");
+
+    fprintf(c, "\nconst uint8_t SCREENS_menu[SCREENS_MENU_ITEMS][2][SCREENS_MENU_W] PROGMEM = {\n");
+    for (int i = 0; i < MENU_ITEMS; i++) {
+        fprintf(c, "    {   // %s\n", menu_items[i]);
+        for (int sel = 0; sel < 2; sel++) {
+            fprintf(c, "        {\n");
+            emit_bytes(c, menu[i][sel], menu_w, "            ");
+            fprintf(c, "        },\n");
+        }
+        fprintf(c, "    },\n");
+    }
+    fprintf(c, "};\n");
+
+    fclose(c);
+    fclose(h);
+    return 0;
+}